@@ -74,6 +74,15 @@ CODE_FRAGMENT
 .  {* ... and here: (``once'' means at least once).  *}
 .  bfd_boolean opened_once;
 .
+.  {* If the whole file has been mapped read-only so that section
+.     contents can be read without the stream, the mapping and its
+.     size.  Only set in the outermost BFD of an archive.  *}
+.  PTR mapping;
+.  bfd_size_type mapping_size;
+.
+.  {* Whether mapping the file has been tried.  *}
+.  bfd_boolean mapping_tried;
+.
 .  {* Set if we have a locally maintained mtime value, rather than
 .     getting it from the file each time.  *}
 .  bfd_boolean mtime_set;
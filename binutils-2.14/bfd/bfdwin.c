@@ -252,4 +252,89 @@ bfd_get_file_window (abfd, offset, size, windowp, writable)
   return TRUE;
 }
 
+/* Files smaller than this are read through stdio as before: the few
+   reads needed for a small file cost less than mapping it.  */
+
+#define MAPPED_FILE_MIN_SIZE (64 * 1024)
+
+/* Copy COUNT bytes at POSITION within ABFD to LOCATION from a read-only
+   mapping of the whole file, mapping it on first use.  A linker reads
+   the contents of many small sections from the same few files, and this
+   saves seeking, reading through stdio, and reopening files the cache
+   has closed, as the mapping outlives the stream.  Returns FALSE without
+   doing anything if the file can't be mapped, or the range is not within
+   it; the caller should then read the file as usual.  Neither the stream
+   nor abfd->where is moved.  */
+
+bfd_boolean
+_bfd_read_mapped_file (abfd, location, position, count)
+     bfd *abfd;
+     PTR location;
+     file_ptr position;
+     bfd_size_type count;
+{
+#ifdef HAVE_MMAP
+  while (abfd->my_archive != NULL)
+    {
+      position += abfd->origin;
+      abfd = abfd->my_archive;
+    }
+
+  if (! abfd->mapping_tried)
+    {
+      struct stat statbuf;
+      PTR data;
+
+      abfd->mapping_tried = TRUE;
+
+      if (! ok_to_map
+	  || (abfd->flags & BFD_IN_MEMORY) != 0
+	  || abfd->direction != read_direction
+	  || bfd_stat (abfd, &statbuf) != 0
+	  || statbuf.st_size < MAPPED_FILE_MIN_SIZE
+	  || (bfd_size_type) (size_t) statbuf.st_size
+	     != (bfd_size_type) statbuf.st_size)
+	return FALSE;
+
+      data = mmap (NULL, (size_t) statbuf.st_size, PROT_READ,
+		   MAP_FILE | MAP_PRIVATE,
+		   fileno (bfd_cache_lookup (abfd)), (off_t) 0);
+      if (data == (PTR) -1)
+	return FALSE;
+
+      if (debug_windows)
+	fprintf (stderr, "mapped all %ld bytes of %s at %p\n",
+		 (long) statbuf.st_size, abfd->filename, data);
+
+      abfd->mapping = data;
+      abfd->mapping_size = statbuf.st_size;
+    }
+
+  if (abfd->mapping == NULL
+      || position < 0
+      || (bfd_size_type) position > abfd->mapping_size
+      || count > abfd->mapping_size - (bfd_size_type) position)
+    return FALSE;
+
+  memcpy (location, (bfd_byte *) abfd->mapping + position, (size_t) count);
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/* Release ABFD's mapping of its file, if it has one.  */
+
+void
+_bfd_unmap_file (abfd)
+     bfd *abfd;
+{
+#ifdef HAVE_MMAP
+  if (abfd->mapping != NULL)
+    munmap (abfd->mapping, (size_t) abfd->mapping_size);
+#endif
+  abfd->mapping = NULL;
+  abfd->mapping_size = 0;
+}
+
 #endif /* USE_MMAP */
@@ -27,8 +27,9 @@ SECTION
 	the application to open as many BFDs as it wants without
 	regard to the underlying operating system's file descriptor
 	limit (often as low as 20 open files).  The module in
-	<<cache.c>> maintains a least recently used list of
-	<<BFD_CACHE_MAX_OPEN>> files, and exports the name
+	<<cache.c>> maintains a least recently used list of as many
+	open files as the process's file descriptor limit comfortably
+	allows, and exports the name
 	<<bfd_cache_lookup>>, which runs around and makes sure that
 	the required BFD is open. If not, then it chooses a file to
 	close, closes it and opens the one wanted, returning its file
@@ -40,6 +41,11 @@ SECTION
 #include "sysdep.h"
 #include "libbfd.h"
 
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+static int bfd_cache_max_open PARAMS ((void));
 static void insert PARAMS ((bfd *));
 static void snip PARAMS ((bfd *));
 static bfd_boolean close_one PARAMS ((void));
@@ -50,8 +56,9 @@ INTERNAL_FUNCTION
 	BFD_CACHE_MAX_OPEN macro
 
 DESCRIPTION
-	The maximum number of files which the cache will keep open at
-	one time.
+	The least number of files which the cache will keep open at
+	one time.  The actual limit is larger if the process may have
+	many files open.
 
 .#define BFD_CACHE_MAX_OPEN 10
 
@@ -61,6 +68,45 @@ DESCRIPTION
 
 static int open_files;
 
+/* The number of BFD files we may have open, once worked out.  */
+
+static int max_open_files;
+
+/* Returns the number of files the cache may keep open.  Linking against
+   libraries of many small members reopens files constantly if this is
+   too low, so use an eighth of the file descriptor limit, leaving the
+   rest to the application, but no fewer than BFD_CACHE_MAX_OPEN and no
+   more than 256: holding thousands of stdio streams and their buffers
+   open costs more than reopening files.  */
+
+static int
+bfd_cache_max_open ()
+{
+  if (max_open_files == 0)
+    {
+      long max = -1;
+
+#if defined (HAVE_GETRLIMIT) && defined (RLIMIT_NOFILE)
+      struct rlimit rlim;
+
+      if (getrlimit (RLIMIT_NOFILE, &rlim) == 0
+	  && rlim.rlim_cur != RLIM_INFINITY)
+	max = rlim.rlim_cur;
+#endif
+#if defined (HAVE_SYSCONF) && defined (_SC_OPEN_MAX)
+      if (max < 0)
+	max = sysconf (_SC_OPEN_MAX);
+#endif
+
+      max /= 8;
+      max_open_files = (max < BFD_CACHE_MAX_OPEN)? BFD_CACHE_MAX_OPEN
+						 : (max > 256)? 256
+						 : (int) max;
+    }
+
+  return max_open_files;
+}
+
 /*
 INTERNAL_FUNCTION
 	bfd_last_cache
@@ -205,7 +251,7 @@ bfd_cache_init (abfd)
      bfd *abfd;
 {
   BFD_ASSERT (abfd->iostream != NULL);
-  if (open_files >= BFD_CACHE_MAX_OPEN)
+  if (open_files >= bfd_cache_max_open ())
     {
       if (! close_one ())
 	return FALSE;
@@ -263,7 +309,7 @@ bfd_open_file (abfd)
 {
   abfd->cacheable = TRUE;	/* Allow it to be closed later.  */
 
-  if (open_files >= BFD_CACHE_MAX_OPEN)
+  if (open_files >= bfd_cache_max_open ())
     {
       if (! close_one ())
 	return NULL;
@@ -336,9 +382,9 @@ SYNOPSIS
 DESCRIPTION
 	Called when the macro <<bfd_cache_lookup>> fails to find a
 	quick answer.  Find a file descriptor for @var{abfd}.  If
-	necessary, it open it.  If there are already more than
-	<<BFD_CACHE_MAX_OPEN>> files open, it tries to close one first, to
-	avoid running out of file descriptors.
+	necessary, it open it.  If the cache is already full, it
+	tries to close one first, to avoid running out of file
+	descriptors.
 */
 
 FILE *
@@ -54,6 +54,10 @@ static void mark_relocs
 #define IS_EXTERNAL(abfd, sym)				\
   ((sym).n_sclass == C_EXT || IS_WEAK_EXTERNAL (abfd, sym))
 
+/* Return TRUE if the relocs are to be copied to the output file: either
+   this is a relocateable link, or --emit-relocs was given.  */
+#define EMIT_RELOCS(info) ((info)->relocateable || (info)->emitrelocations)
+
 /* Define macros so that the ISFCN, et. al., macros work correctly.
    These macros are defined in include/coff/internal.h in terms of
    N_TMASK, etc.  These definitions require a user to define local
@@ -739,7 +743,7 @@ _bfd_coff_final_link (abfd, info)
 		  || info->strip == strip_some)
 		o->lineno_count += sec->lineno_count;
 
-	      if (info->relocateable)
+	      if (EMIT_RELOCS (info))
 		o->reloc_count += sec->reloc_count;
 
 	      if (sec->_raw_size > max_contents_size)
@@ -782,9 +786,9 @@ _bfd_coff_final_link (abfd, info)
 	}
     }
 
-  /* If doing a relocateable link, allocate space for the pointers we
-     need to keep.  */
-  if (info->relocateable)
+  /* If doing a relocateable link, or emitting relocs from a final link,
+     allocate space for the pointers we need to keep.  */
+  if (EMIT_RELOCS (info))
     {
       unsigned int i;
 
@@ -830,9 +834,9 @@ _bfd_coff_final_link (abfd, info)
 
 	     Because of this problem, we also keep the relocs in
 	     memory until the end of the link.  This wastes memory,
-	     but only when doing a relocateable link, which is not the
-	     common case.  */
-	  BFD_ASSERT (info->relocateable);
+	     but only when doing a relocateable link or emitting relocs,
+	     which is not the common case.  */
+	  BFD_ASSERT (EMIT_RELOCS (info));
 	  amt = o->reloc_count;
 	  amt *= sizeof (struct internal_reloc);
 	  finfo.section_info[o->target_index].relocs =
@@ -1033,7 +1037,7 @@ _bfd_coff_final_link (abfd, info)
       finfo.outsyms = NULL;
     }
 
-  if (info->relocateable && max_output_reloc_count > 0)
+  if (EMIT_RELOCS (info) && max_output_reloc_count > 0)
     {
       /* Now that we have written out all the global symbols, we know
 	 the symbol indices to use for relocs against them, and we can
@@ -1334,8 +1338,8 @@ mark_relocs (finfo, input_bfd)
       internal_relocs = _bfd_coff_read_internal_relocs
 	(input_bfd, a, FALSE,
 	 finfo->external_relocs,
-	 finfo->info->relocateable,
-	 (finfo->info->relocateable
+	 EMIT_RELOCS (finfo->info),
+	 (EMIT_RELOCS (finfo->info)
 	  ? (finfo->section_info[ a->output_section->target_index ].relocs + a->output_section->reloc_count)
 	  : finfo->internal_relocs)
 	);
@@ -1430,7 +1434,7 @@ _bfd_coff_link_input_bfd (finfo, input_bfd)
      going to be involved in the relocations */
   if ((   finfo->info->strip   != strip_none
        || finfo->info->discard != discard_none)
-      && finfo->info->relocateable)
+      && EMIT_RELOCS (finfo->info))
     {
       /* mark the symbol array as 'not-used' */
       memset (indexp, 0, obj_raw_syment_count (input_bfd) * sizeof * indexp);
@@ -1477,7 +1481,7 @@ _bfd_coff_link_input_bfd (finfo, input_bfd)
          relocation.  */
       if ((finfo->info->strip != strip_none
 	   || finfo->info->discard != discard_none)
-	  && finfo->info->relocateable)
+	  && EMIT_RELOCS (finfo->info))
 	dont_skip_symbol = *indexp;
       else
 	dont_skip_symbol = FALSE;
@@ -2356,8 +2360,8 @@ _bfd_coff_link_input_bfd (finfo, input_bfd)
 	  target_index = o->output_section->target_index;
 	  internal_relocs = (_bfd_coff_read_internal_relocs
 			     (input_bfd, o, FALSE, finfo->external_relocs,
-			      finfo->info->relocateable,
-			      (finfo->info->relocateable
+			      EMIT_RELOCS (finfo->info),
+			      (EMIT_RELOCS (finfo->info)
 			       ? (finfo->section_info[target_index].relocs
 				  + o->output_section->reloc_count)
 			       : finfo->internal_relocs)));
@@ -2374,7 +2378,7 @@ _bfd_coff_link_input_bfd (finfo, input_bfd)
 					   finfo->sec_ptrs))
 	    return FALSE;
 
-	  if (finfo->info->relocateable)
+	  if (EMIT_RELOCS (finfo->info))
 	    {
 	      bfd_vma offset;
 	      struct internal_reloc *irelend;
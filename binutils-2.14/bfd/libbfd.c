@@ -761,6 +761,12 @@ _bfd_generic_get_section_contents (abfd, section, location, offset, count)
       return FALSE;
     }
 
+#ifdef USE_MMAP
+  if (_bfd_read_mapped_file (abfd, location, section->filepos + offset,
+			     count))
+    return TRUE;
+#endif
+
   if (bfd_seek (abfd, section->filepos + offset, SEEK_SET) != 0
       || bfd_bread (location, count, abfd) != count)
     return FALSE;
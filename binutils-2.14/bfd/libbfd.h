@@ -139,6 +139,12 @@ bfd * _bfd_new_bfd
 void _bfd_delete_bfd
   PARAMS ((bfd *));
 
+/* Reading section contents from a mapping of the whole file (bfdwin.c).  */
+extern bfd_boolean _bfd_read_mapped_file
+  PARAMS ((bfd *, PTR, file_ptr, bfd_size_type));
+extern void _bfd_unmap_file
+  PARAMS ((bfd *));
+
 bfd_boolean bfd_false
   PARAMS ((bfd *ignore));
 bfd_boolean bfd_true
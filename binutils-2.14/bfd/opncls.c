@@ -117,6 +117,9 @@ void
 _bfd_delete_bfd (abfd)
      bfd *abfd;
 {
+#ifdef USE_MMAP
+  _bfd_unmap_file (abfd);
+#endif
   bfd_hash_table_free (&abfd->section_htab);
   objalloc_free ((struct objalloc *) abfd->memory);
   free (abfd);
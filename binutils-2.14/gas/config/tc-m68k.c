@@ -349,6 +349,9 @@ static void s_mri_until PARAMS ((int));
 static void s_mri_while PARAMS ((int));
 static void s_mri_endw PARAMS ((int));
 static void md_convert_frag_1 PARAMS ((fragS *));
+static long relax_growth_before PARAMS ((const long *, int));
+struct relax_tree;
+static void relax_set_trigger PARAMS ((struct relax_tree *, int, long));
 
 static int current_architecture;
 
@@ -4699,6 +4702,384 @@ md_estimate_size_before_relax (fragP, segment)
   return md_relax_table[fragP->fr_subtype].rlx_length;
 }
 
+/* relax_segment finds the size of each variable frag by making passes
+   over the whole segment until a pass changes nothing.  A long chain of
+   branches, each of which only grows once the one after it has grown,
+   takes one pass per link, and so time quadratic in the size of the
+   segment.  Here is the same relaxation done with a worklist: a branch is
+   looked at again only when the frags between it and its target have
+   grown by more than it has room for.
+
+   Branch frags only ever grow, and always by an even amount, so this
+   comes to the same fixed point as relax_segment's passes, with the same
+   frag sizes.  The growth of each frag is kept in a Fenwick tree, so the
+   current address of any frag can be had in logarithmic time.  The range
+   of frags each branch spans is split over the nodes of a segment tree
+   covering the frags, and its slack (how much that range can grow before
+   the branch no longer fits) is shared out between those parts.  Each
+   node keeps the total growth below it, and a heap of its parts ordered
+   by the growth at which their share runs out; when it does, the branch
+   is looked at again.
+
+   This only works if nothing in the segment changes size other than the
+   branches, and only by something with a known target in the segment.
+   Anything else (alignment beyond a word, .org, .space with a symbol,
+   leb128 or debug frags, or branches to symbols this can't follow), and
+   this returns 0 without having changed anything, leaving relax_segment
+   to do its passes as usual.  Otherwise the frags are fully relaxed and
+   their addresses set, and this returns 1.  */
+
+#define NO_TRIGGER ((long) (~0UL >> 1))
+
+struct relax_span
+{
+  int frag;			/* Index of the branch frag.  */
+  int node;			/* Segment tree node this part is at.  */
+  int heap_index;		/* Its place in the node's heap.  */
+  long trigger;			/* Look again at the branch when the
+				   node's growth reaches this.  */
+};
+
+struct relax_tree
+{
+  struct relax_span *spans;
+  int *heap;			/* Node K's heap of spans is from
+				   heap[first[K]] to heap[first[K + 1]].  */
+  int *first;
+};
+
+/* Return the total growth of the frags before the I'th, from the Fenwick
+   tree GROWTH, in which element K (from 1) holds the growth of frags
+   K - (K & -K) to K - 1.  */
+
+static long
+relax_growth_before (growth, i)
+     const long *growth;
+     int i;
+{
+  long sum = 0;
+
+  for (; i > 0; i -= i & -i)
+    sum += growth[i];
+  return sum;
+}
+
+/* Change the trigger of span S to TRIGGER, and move it in its node's
+   heap to suit.  */
+
+static void
+relax_set_trigger (tree, s, trigger)
+     struct relax_tree *tree;
+     int s;
+     long trigger;
+{
+  struct relax_span *spans = tree->spans;
+  int *heap = tree->heap + tree->first[spans[s].node];
+  int count = tree->first[spans[s].node + 1] - tree->first[spans[s].node];
+  int pos = spans[s].heap_index;
+
+  spans[s].trigger = trigger;
+  while (pos > 0 && spans[heap[(pos - 1) / 2]].trigger > trigger)
+    {
+      heap[pos] = heap[(pos - 1) / 2];
+      spans[heap[pos]].heap_index = pos;
+      pos = (pos - 1) / 2;
+    }
+  for (;;)
+    {
+      int child = 2 * pos + 1;
+
+      if (child >= count)
+	break;
+      if (child + 1 < count
+	  && spans[heap[child + 1]].trigger < spans[heap[child]].trigger)
+	child++;
+      if (spans[heap[child]].trigger >= trigger)
+	break;
+      heap[pos] = heap[child];
+      spans[heap[pos]].heap_index = pos;
+      pos = child;
+    }
+  heap[pos] = s;
+  spans[s].heap_index = pos;
+}
+
+int
+m68k_relax_segment (root, segment)
+     fragS *root;
+     segT segment;
+{
+  fragS *fragP;
+  fragS **frags;
+  addressT *base;
+  long *growth, *node_growth;
+  int *target, *first_span, *queue;
+  char *queued;
+  struct relax_tree tree;
+  int nspans, maxspans;
+  int n, size, i, k;
+  int q_head, q_count;
+
+  n = 0;
+  for (fragP = root; fragP; fragP = fragP->fr_next)
+    {
+      switch (fragP->fr_type)
+	{
+	case rs_fill:
+	  break;
+
+	case rs_space:
+	  if (fragP->fr_symbol != NULL)
+	    return 0;
+	  break;
+
+	case rs_align:
+	case rs_align_code:
+	case rs_align_test:
+	  /* Growth is always even, so word alignment padding never
+	     changes.  */
+	  if (fragP->fr_offset > 1)
+	    return 0;
+	  break;
+
+	case rs_machine_dependent:
+	  if (md_relax_table[fragP->fr_subtype].rlx_more != 0
+	      && (fragP->fr_symbol == NULL
+		  || S_GET_SEGMENT (fragP->fr_symbol) != segment
+		  || ! symbol_constant_p (fragP->fr_symbol)))
+	    return 0;
+	  break;
+
+	default:
+	  return 0;
+	}
+      n++;
+    }
+
+  if (n == 0)
+    return 1;
+
+  frags = (fragS **) xmalloc (n * sizeof (fragS *));
+  base = (addressT *) xmalloc (n * sizeof (addressT));
+  growth = (long *) xmalloc ((n + 1) * sizeof (long));
+  target = (int *) xmalloc (n * sizeof (int));
+
+  for (i = 0, fragP = root; fragP; i++, fragP = fragP->fr_next)
+    {
+      frags[i] = fragP;
+      base[i] = fragP->fr_address;
+      growth[i + 1] = 0;
+      target[i] = -1;
+    }
+
+  /* Find the frag each branch goes to.  The frag addresses are still
+     relax_segment's first guesses, which are in order, so search by
+     address and then among any empty frags at that address.  */
+  for (i = 0; i < n; i++)
+    {
+      fragS *sym_frag;
+      addressT address;
+      int lo, hi;
+
+      fragP = frags[i];
+      if (fragP->fr_type != rs_machine_dependent
+	  || md_relax_table[fragP->fr_subtype].rlx_more == 0)
+	continue;
+
+      sym_frag = symbol_get_frag (fragP->fr_symbol);
+      address = sym_frag->fr_address;
+      lo = 0;
+      hi = n;
+      while (lo < hi)
+	{
+	  int mid = lo + (hi - lo) / 2;
+	  if (base[mid] < address)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+      for (k = lo; k < n && base[k] == address; k++)
+	if (frags[k] == sym_frag)
+	  break;
+      if (k == n || frags[k] != sym_frag)
+	{
+	  free (frags);
+	  free (base);
+	  free (growth);
+	  free (target);
+	  return 0;
+	}
+      target[i] = k;
+    }
+
+  /* Split the frags each branch spans over the segment tree: a forward
+     branch's distance includes its own variable part, a backward
+     branch's doesn't.  A branch's spans are kept together, from
+     first_span[i] to first_span[i + 1].  */
+  for (size = 1; size < n; size <<= 1)
+    ;
+  first_span = (int *) xmalloc ((n + 1) * sizeof (int));
+  nspans = 0;
+  maxspans = n;
+  tree.spans = ((struct relax_span *)
+		xmalloc (maxspans * sizeof (struct relax_span)));
+  for (i = 0; i < n; i++)
+    {
+      int lo, hi;
+
+      first_span[i] = nspans;
+      if (target[i] < 0)
+	continue;
+      if (target[i] > i)
+	lo = i, hi = target[i];
+      else
+	lo = target[i], hi = i;
+      for (lo += size, hi += size; lo < hi; lo >>= 1, hi >>= 1)
+	{
+	  int nodes[2], j;
+
+	  nodes[0] = (lo & 1) ? lo++ : 0;
+	  nodes[1] = (hi & 1) ? --hi : 0;
+	  for (j = 0; j < 2; j++)
+	    if (nodes[j] != 0)
+	      {
+		if (nspans == maxspans)
+		  {
+		    maxspans *= 2;
+		    tree.spans = ((struct relax_span *)
+				  xrealloc (tree.spans,
+					    (maxspans
+					     * sizeof (struct relax_span))));
+		  }
+		tree.spans[nspans].frag = i;
+		tree.spans[nspans].node = nodes[j];
+		tree.spans[nspans].trigger = NO_TRIGGER;
+		nspans++;
+	      }
+	}
+    }
+  first_span[n] = nspans;
+
+  /* Put each node's spans in its heap; with no triggers yet, any order
+     will do.  */
+  tree.first = (int *) xmalloc ((2 * size + 1) * sizeof (int));
+  tree.heap = (int *) xmalloc ((nspans + 1) * sizeof (int));
+  node_growth = (long *) xmalloc (2 * size * sizeof (long));
+  for (k = 0; k < 2 * size; k++)
+    {
+      tree.first[k] = 0;
+      node_growth[k] = 0;
+    }
+  for (k = 0; k < nspans; k++)
+    tree.first[tree.spans[k].node]++;
+  for (k = 1; k < 2 * size; k++)
+    tree.first[k] += tree.first[k - 1];
+  tree.first[2 * size] = nspans;
+  for (k = nspans - 1; k >= 0; k--)
+    tree.heap[--tree.first[tree.spans[k].node]] = k;
+  for (k = 0; k < nspans; k++)
+    {
+      struct relax_span *s = &tree.spans[tree.heap[k]];
+
+      s->heap_index = k - tree.first[s->node];
+    }
+
+  queue = (int *) xmalloc (n * sizeof (int));
+  queued = (char *) xmalloc (n);
+  q_head = 0;
+  q_count = 0;
+  for (i = 0; i < n; i++)
+    {
+      queued[i] = target[i] >= 0;
+      if (queued[i])
+	queue[q_count++] = i;
+    }
+
+  while (q_count > 0)
+    {
+      const relax_typeS *this_type;
+      long grew, share;
+      int t;
+
+      i = queue[q_head];
+      q_head = (q_head + 1) % n;
+      q_count--;
+
+      fragP = frags[i];
+      t = target[i];
+
+      /* relax_frag only looks at the address of the branch and of the
+	 frag it goes to, so bring just those two up to date.  */
+      fragP->fr_address = base[i] + relax_growth_before (growth, i);
+      frags[t]->fr_address = base[t] + relax_growth_before (growth, t);
+
+      grew = relax_frag (segment, fragP, 0L);
+      if (grew != 0)
+	{
+	  for (k = i + 1; k <= n; k += k & -k)
+	    growth[k] += grew;
+	  frags[t]->fr_address = base[t] + relax_growth_before (growth, t);
+
+	  /* Look again at the branches spanning this one whose share of
+	     their slack at some node has now run out.  */
+	  for (k = i + size; k > 0; k >>= 1)
+	    {
+	      node_growth[k] += grew;
+	      while (tree.first[k] < tree.first[k + 1])
+		{
+		  int s = tree.heap[tree.first[k]];
+
+		  if (tree.spans[s].trigger > node_growth[k])
+		    break;
+		  relax_set_trigger (&tree, s, NO_TRIGGER);
+		  if (! queued[tree.spans[s].frag])
+		    {
+		      queue[(q_head + q_count) % n] = tree.spans[s].frag;
+		      q_count++;
+		      queued[tree.spans[s].frag] = 1;
+		    }
+		}
+	    }
+	}
+      queued[i] = 0;
+
+      /* Share out the room this branch has left between its spans.  */
+      this_type = md_relax_table + fragP->fr_subtype;
+      share = -1;
+      if (this_type->rlx_more != 0 && first_span[i] < first_span[i + 1])
+	{
+	  offsetT aim;
+	  long slack;
+
+	  aim = (S_GET_VALUE (fragP->fr_symbol) + fragP->fr_offset
+		 - fragP->fr_address - fragP->fr_fix);
+	  slack = aim < 0 ? aim - this_type->rlx_backward
+			  : this_type->rlx_forward - aim;
+	  share = slack / (first_span[i + 1] - first_span[i]);
+	}
+      for (k = first_span[i]; k < first_span[i + 1]; k++)
+	relax_set_trigger (&tree, k,
+			   (share < 0 ? NO_TRIGGER
+			    : node_growth[tree.spans[k].node] + share + 1));
+    }
+
+  for (i = 0; i < n; i++)
+    frags[i]->fr_address = base[i] + relax_growth_before (growth, i);
+
+  free (tree.spans);
+  free (tree.heap);
+  free (tree.first);
+  free (node_growth);
+  free (frags);
+  free (base);
+  free (growth);
+  free (target);
+  free (first_span);
+  free (queue);
+  free (queued);
+  return 1;
+}
+
 #if defined(OBJ_AOUT) | defined(OBJ_BOUT)
 /* the bit-field entries in the relocation_info struct plays hell
    with the byte-order problems of cross-assembly.  So as a hack,
@@ -209,6 +209,10 @@ extern int m68k_parse_long_option PARAMS ((char *));
 extern struct relax_type md_relax_table[];
 #define TC_GENERIC_RELAX_TABLE md_relax_table
 
+/* Relax a segment's branches with a worklist, where it can.  */
+extern int m68k_relax_segment PARAMS ((struct frag *, segT));
+#define md_relax_segment(root, segment) m68k_relax_segment (root, segment)
+
 /* We can't do a byte jump to the next instruction, so in that case
    force word mode by faking AIM.  */
 #define md_prepare_relax_scan(fragP, address, aim, this_state, this_type) \
@@ -2292,6 +2292,11 @@ relax_segment (segment_frag_root, segment)
 	}
     }
 
+#ifdef md_relax_segment
+  /* The target may relax the segment itself, more quickly than the passes
+     below but to the same result, when it can tell how.  */
+  if (! md_relax_segment (segment_frag_root, segment))
+#endif
   /* Do relax().  */
   {
     long stretch;	/* May be any size, 0 or negative.  */
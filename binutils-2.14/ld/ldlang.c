@@ -88,6 +88,14 @@ static void already_linked_table_free
   PARAMS ((void));
 static bfd_boolean wildcardp
   PARAMS ((const char *));
+static struct bfd_hash_entry *section_name_newfunc
+  PARAMS ((struct bfd_hash_entry *, struct bfd_hash_table *, const char *));
+static void section_name_add_file
+  PARAMS ((lang_input_statement_type *));
+static void section_name_table_init
+  PARAMS ((void));
+static void section_name_table_free
+  PARAMS ((void));
 static lang_statement_union_type *wild_sort
   PARAMS ((lang_wild_statement_type *, struct wildcard_list *,
 	   lang_input_statement_type *, asection *));
@@ -213,6 +221,8 @@ static void walk_wild_section
 static void walk_wild_file
   PARAMS ((lang_wild_statement_type *, lang_input_statement_type *,
 	   callback_t, PTR));
+static bfd_boolean walk_wild_by_name
+  PARAMS ((lang_wild_statement_type *, callback_t, PTR));
 static int get_target
   PARAMS ((const bfd_target *, PTR));
 static void stricpy
@@ -400,6 +410,190 @@ walk_wild_file (s, f, callback, data)
     }
 }
 
+/* An index of all the input sections by name, so that a statement
+   such as *(.text) can find its sections without comparing its
+   section name against every section of every input file.  This
+   matters for generated linker scripts with one such statement for
+   each of many sections.  The index is only built while the wild
+   statements are being walked, since input sections can be created
+   up until then.  Each name's sections are listed in the order that
+   walk_wild_file would visit them, and are numbered so that the
+   lists for several names can be merged back into that order.  */
+
+struct section_name_hash_entry
+{
+  struct bfd_hash_entry root;
+  struct section_name_entry *first;
+  struct section_name_entry **last;
+};
+
+struct section_name_entry
+{
+  struct section_name_entry *next;
+  asection *section;
+  lang_input_statement_type *file;
+  unsigned int order;
+};
+
+static struct bfd_hash_table section_name_table;
+static bfd_boolean section_name_table_valid;
+static unsigned int section_name_order;
+
+static struct bfd_hash_entry *
+section_name_newfunc (entry, table, string)
+     struct bfd_hash_entry *entry ATTRIBUTE_UNUSED;
+     struct bfd_hash_table *table;
+     const char *string ATTRIBUTE_UNUSED;
+{
+  struct section_name_hash_entry *ret =
+    bfd_hash_allocate (table, sizeof (struct section_name_hash_entry));
+
+  ret->first = NULL;
+  ret->last = &ret->first;
+
+  return (struct bfd_hash_entry *) ret;
+}
+
+static void
+section_name_add_file (file)
+     lang_input_statement_type *file;
+{
+  asection *s;
+
+  if (file->just_syms_flag)
+    return;
+
+  for (s = file->the_bfd->sections; s != NULL; s = s->next)
+    {
+      struct section_name_hash_entry *h;
+      struct section_name_entry *e;
+
+      h = ((struct section_name_hash_entry *)
+	   bfd_hash_lookup (&section_name_table,
+			    bfd_get_section_name (file->the_bfd, s),
+			    TRUE, FALSE));
+      if (h == NULL)
+	einfo (_("%P%F: bfd_hash_lookup failed: %E\n"));
+
+      e = ((struct section_name_entry *)
+	   bfd_hash_allocate (&section_name_table, sizeof *e));
+      e->next = NULL;
+      e->section = s;
+      e->file = file;
+      e->order = section_name_order++;
+      *h->last = e;
+      h->last = &e->next;
+    }
+}
+
+static void
+section_name_table_init ()
+{
+  if (! bfd_hash_table_init_n (&section_name_table,
+			       section_name_newfunc,
+			       1021))
+    einfo (_("%P%F: Failed to create hash table\n"));
+
+  section_name_order = 0;
+
+  /* Visit the files exactly as walk_wild_file does.  */
+  LANG_FOR_EACH_INPUT_STATEMENT (f)
+    {
+      if (f->the_bfd == NULL)
+	continue;
+
+      if (! bfd_check_format (f->the_bfd, bfd_archive))
+	section_name_add_file (f);
+      else
+	{
+	  bfd *member;
+
+	  for (member = bfd_openr_next_archived_file (f->the_bfd, NULL);
+	       member != NULL;
+	       member = bfd_openr_next_archived_file (f->the_bfd, member))
+	    if (member->usrdata != NULL)
+	      section_name_add_file ((lang_input_statement_type *)
+				     member->usrdata);
+	}
+    }
+
+  section_name_table_valid = TRUE;
+}
+
+static void
+section_name_table_free ()
+{
+  section_name_table_valid = FALSE;
+  bfd_hash_table_free (&section_name_table);
+}
+
+/* Walk the wild statement S using the section name index, if S applies
+   to all files and names its sections without wildcards or exclusions.
+   The callbacks are made in the same order as walk_wild_section would
+   make them.  Returns FALSE if S has to be walked the long way.  */
+
+static bfd_boolean
+walk_wild_by_name (s, callback, data)
+     lang_wild_statement_type *s;
+     callback_t callback;
+     PTR data;
+{
+  struct wildcard_list *sec;
+  struct section_name_entry **next;
+  int count, i;
+
+  if (! section_name_table_valid || s->section_list == NULL)
+    return FALSE;
+
+  count = 0;
+  for (sec = s->section_list; sec != NULL; sec = sec->next)
+    {
+      if (sec->spec.name == NULL
+	  || sec->spec.exclude_name_list != NULL
+	  || wildcardp (sec->spec.name))
+	return FALSE;
+      count++;
+    }
+
+  /* Start with each name's list of sections, then repeatedly take the
+     earliest section in walk order; a section matched by two names is
+     passed to the callback for each, in the order of the names.  */
+  next = ((struct section_name_entry **)
+	  xmalloc (count * sizeof (struct section_name_entry *)));
+  for (sec = s->section_list, i = 0; sec != NULL; sec = sec->next, i++)
+    {
+      struct section_name_hash_entry *h;
+
+      h = ((struct section_name_hash_entry *)
+	   bfd_hash_lookup (&section_name_table, sec->spec.name,
+			    FALSE, FALSE));
+      next[i] = h != NULL ? h->first : NULL;
+    }
+
+  for (;;)
+    {
+      struct wildcard_list *best_sec = NULL;
+      int best = -1;
+
+      for (sec = s->section_list, i = 0; sec != NULL; sec = sec->next, i++)
+	if (next[i] != NULL
+	    && (best < 0 || next[i]->order < next[best]->order))
+	  {
+	    best = i;
+	    best_sec = sec;
+	  }
+
+      if (best < 0)
+	break;
+
+      (*callback) (s, best_sec, next[best]->section, next[best]->file, data);
+      next[best] = next[best]->next;
+    }
+
+  free (next);
+  return TRUE;
+}
+
 static void
 walk_wild (s, callback, data)
      lang_wild_statement_type *s;
@@ -410,6 +604,9 @@ walk_wild (s, callback, data)
 
   if (file_spec == NULL)
     {
+      if (walk_wild_by_name (s, callback, data))
+	return;
+
       /* Perform the iteration over all files in the list.  */
       LANG_FOR_EACH_INPUT_STATEMENT (f)
 	{
@@ -4248,7 +4445,9 @@ lang_gc_sections ()
 
   /* Keep all sections so marked in the link script.  */
 
+  section_name_table_init ();
   lang_gc_sections_1 (statement_list.head);
+  section_name_table_free ();
 
   /* Keep all sections containing symbols undefined on the command-line,
      and the section containing the entry symbol.  */
@@ -4328,8 +4527,10 @@ lang_process ()
 
   /* Run through the contours of the script and attach input sections
      to the correct output sections.  */
+  section_name_table_init ();
   map_input_to_output_sections (statement_list.head, (char *) NULL,
 				(lang_output_section_statement_type *) NULL);
+  section_name_table_free ();
 
   /* Find any sections not attached explicitly and handle them.  */
   lang_place_orphans ();
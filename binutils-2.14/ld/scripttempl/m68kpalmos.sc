@@ -60,6 +60,10 @@ cat <<EOF
 	data_start = .;
 	*(.data)
 	*(.gcc_exc)
+	. = ALIGN(2);
+	dtraps_start = .;
+	*(dtraps)
+	dtraps_end = .;
     } > datares
     .bss :
     {
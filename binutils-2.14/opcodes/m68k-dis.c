@@ -46,6 +46,9 @@ static int
 print_insn_arg PARAMS ((const char *, unsigned char *, unsigned char *,
 			bfd_vma, disassemble_info *));
 
+static void
+build_decode_table PARAMS ((int));
+
 const char * const fpcr_names[] = {
     "", "%fpiar", "%fpsr", "%fpiar/%fpsr", "%fpcr",
     "%fpiar/%fpcr", "%fpsr/%fpcr", "%fpiar/%fpsr/%fpcr"
@@ -169,6 +172,124 @@ dummy_print_address (vma, info)
 {
 }
 
+/* The opcode table, sorted on the upper four bits of the opcode.  */
+static int numopcodes[16];
+static const struct m68k_opcode **opcodes[16];
+
+/* Properties of each opcode's arguments that decide whether it can be
+   chosen for printout, indexed like m68k_opcodes.  */
+static unsigned char *opcode_flags;
+
+/* A variant of divul or divsl, or of most floating point coprocessor
+   instructions, that has the same register number in two places.
+   These are never used for printout; the more general variants will
+   match instead.  */
+#define OPCODE_SAME_REGISTER_TWICE 1
+
+/* Has an "s8" argument, a register list that must name exactly one
+   register for the opcode to be used (fmovel rather than fmoveml).  */
+#define OPCODE_HAS_S8 2
+
+/* Decode tables, one per major opcode (the upper four bits of the first
+   instruction word), built the first time an instruction with that
+   major opcode is seen.  For each of the 4096 possible first words,
+   CLASS_OF gives the class of opcodes whose first-word bits match it;
+   the opcodes in class C are POOL[CLASS_START[C]] up to (but not
+   including) POOL[CLASS_START[C + 1]], in opcode table order.  Most
+   words share their class with many others, which keeps the pool
+   small.  Only the second word and the architecture remain to be
+   checked for each candidate.  */
+struct decode_table
+{
+  unsigned short *class_of;
+  unsigned int *class_start;
+  const struct m68k_opcode **pool;
+};
+
+static struct decode_table decode_tables[16];
+
+/* Size of the hash table used to find duplicate classes while
+   building a decode table; a power of two greater than 4096.  */
+#define DECODE_HASH_SIZE 8192
+
+static void
+build_decode_table (major)
+     int major;
+{
+  struct decode_table *table = &decode_tables[major];
+  const struct m68k_opcode **bucket = opcodes[major];
+  int nbucket = numopcodes[major];
+  const struct m68k_opcode **list;
+  int *hash_class;
+  unsigned int pool_size, pool_allocated;
+  int nclasses, nlist, i, w;
+
+  table->class_of = (unsigned short *) xmalloc (4096 * sizeof (unsigned short));
+  table->class_start = (unsigned int *) xmalloc (4097 * sizeof (unsigned int));
+  list = ((const struct m68k_opcode **)
+	  xmalloc ((nbucket + 1) * sizeof (struct m68k_opcode *)));
+  hash_class = (int *) xmalloc (DECODE_HASH_SIZE * sizeof (int));
+  for (i = 0; i < DECODE_HASH_SIZE; i++)
+    hash_class[i] = -1;
+
+  pool_allocated = nbucket + 1;
+  table->pool = ((const struct m68k_opcode **)
+		 xmalloc (pool_allocated * sizeof (struct m68k_opcode *)));
+  pool_size = 0;
+  nclasses = 0;
+
+  for (w = 0; w < 4096; w++)
+    {
+      unsigned int word = (major << 12) | w;
+      unsigned int hash = 0;
+      int h;
+
+      nlist = 0;
+      for (i = 0; i < nbucket; i++)
+	if ((word & (bucket[i]->match >> 16))
+	    == ((bucket[i]->opcode >> 16) & 0xffff))
+	  {
+	    list[nlist++] = bucket[i];
+	    hash = hash * 31 + i;
+	  }
+      hash = (hash * 31 + nlist) & (DECODE_HASH_SIZE - 1);
+
+      /* Look for an existing class with the same opcodes.  */
+      for (h = hash; hash_class[h] != -1; h = (h + 1) & (DECODE_HASH_SIZE - 1))
+	{
+	  int c = hash_class[h];
+	  unsigned int start = table->class_start[c];
+
+	  if (table->class_start[c + 1] - start == (unsigned int) nlist
+	      && memcmp (table->pool + start, list,
+			 nlist * sizeof (struct m68k_opcode *)) == 0)
+	    break;
+	}
+
+      if (hash_class[h] == -1)
+	{
+	  if (pool_size + nlist > pool_allocated)
+	    {
+	      pool_allocated = 2 * pool_allocated + nlist;
+	      table->pool = ((const struct m68k_opcode **)
+			     xrealloc (table->pool, (pool_allocated
+						     * sizeof (struct m68k_opcode *))));
+	    }
+	  memcpy (table->pool + pool_size, list,
+		  nlist * sizeof (struct m68k_opcode *));
+	  hash_class[h] = nclasses;
+	  table->class_start[nclasses] = pool_size;
+	  pool_size += nlist;
+	  table->class_start[++nclasses] = pool_size;
+	}
+
+      table->class_of[w] = hash_class[h];
+    }
+
+  free (list);
+  free (hash_class);
+}
+
 /* Print the m68k instruction at address MEMADDR in debugged memory,
    on INFO->STREAM.  Returns length of the instruction, in bytes.  */
 
@@ -190,8 +311,8 @@ print_insn_m68k (memaddr, info)
   void (*save_print_address) PARAMS ((bfd_vma, struct disassemble_info *))
     = info->print_address_func;
   int major_opcode;
-  static int numopcodes[16];
-  static const struct m68k_opcode **opcodes[16];
+  struct decode_table *table;
+  unsigned int first_word, candidates, end;
 
   if (!opcodes[0])
     {
@@ -218,6 +339,18 @@ print_insn_m68k (memaddr, info)
       for (i = 0; i < m68k_numopcodes; i++)
 	*opc_pointer[(m68k_opcodes[i].opcode >> 28) & 15]++ = &m68k_opcodes[i];
 
+      opcode_flags = (unsigned char *) xmalloc (m68k_numopcodes);
+      for (i = 0; i < m68k_numopcodes; i++)
+	{
+	  opcode_flags[i] = 0;
+	  for (d = m68k_opcodes[i].args; *d; d += 2)
+	    {
+	      if (d[1] == 'D' || d[1] == 't')
+		opcode_flags[i] |= OPCODE_SAME_REGISTER_TWICE;
+	      if (d[0] == 's' && d[1] == '8')
+		opcode_flags[i] |= OPCODE_HAS_S8;
+	    }
+	}
     }
 
   info->private_data = (PTR) &priv;
@@ -278,17 +411,23 @@ print_insn_m68k (memaddr, info)
 
   bestmask = 0;
   FETCH_DATA (info, buffer + 2);
-  major_opcode = (buffer[0] >> 4) & 15;
-  for (i = 0; i < numopcodes[major_opcode]; i++)
+  first_word = ((buffer[0] & 0xff) << 8) | (buffer[1] & 0xff);
+  major_opcode = first_word >> 12;
+  table = &decode_tables[major_opcode];
+  if (table->class_of == NULL)
+    build_decode_table (major_opcode);
+
+  /* Every candidate already matches the first word.  */
+  candidates = table->class_of[first_word & 0xfff];
+  end = table->class_start[candidates + 1];
+  for (i = table->class_start[candidates]; i < (int) end; i++)
     {
-      const struct m68k_opcode *opc = opcodes[major_opcode][i];
+      const struct m68k_opcode *opc = table->pool[i];
       unsigned long opcode = opc->opcode;
       unsigned long match = opc->match;
 
-      if (((0xff & buffer[0] & (match >> 24)) == (0xff & (opcode >> 24)))
-	  && ((0xff & buffer[1] & (match >> 16)) == (0xff & (opcode >> 16)))
-	  /* Only fetch the next two bytes if we need to.  */
-	  && (((0xffff & match) == 0)
+      /* Only fetch the next two bytes if we need to.  */
+      if ((((0xffff & match) == 0)
 	      ||
 	      (FETCH_DATA (info, buffer + 4)
 	       && ((0xff & buffer[2] & (match >> 8)) == (0xff & (opcode >> 8)))
@@ -296,24 +435,15 @@ print_insn_m68k (memaddr, info)
 	      )
 	  && (opc->arch & arch_mask) != 0)
 	{
-	  /* Don't use for printout the variants of divul and divsl
-	     that have the same register number in two places.
-	     The more general variants will match instead.  */
-	  for (d = opc->args; *d; d += 2)
-	    if (d[1] == 'D')
-	      break;
+	  int flags = opcode_flags[opc - m68k_opcodes];
 
-	  /* Don't use for printout the variants of most floating
-	     point coprocessor instructions which use the same
-	     register number in two places, as above. */
-	  if (*d == '\0')
-	    for (d = opc->args; *d; d += 2)
-	      if (d[1] == 't')
-		break;
+	  if (flags & OPCODE_SAME_REGISTER_TWICE)
+	    continue;
 
 	  /* Don't match fmovel with more than one register; wait for
              fmoveml.  */
-	  if (*d == '\0')
+	  d = "";
+	  if (flags & OPCODE_HAS_S8)
 	    {
 	      for (d = opc->args; *d; d += 2)
 		{
@@ -0,0 +1,206 @@
+/* Exercises memcpy, memmove, memset, memcmp, and strlen over a range of
+   lengths and alignments, and prints a digest of the results for each
+   length.  Built for the host, this records what glibc does; built for
+   ARM and run on the simulator, it shows what libc/arm/memstring.S does.
+   The two outputs should be identical.  */
+
+#include <stddef.h>
+
+#ifdef __arm__
+void *memcpy (void *, const void *, size_t);
+void *memmove (void *, const void *, size_t);
+void *memset (void *, int, size_t);
+int memcmp (const void *, const void *, size_t);
+size_t strlen (const char *);
+
+static void
+put (const char *s) {
+  register const char *r0 asm ("r0") = s;
+  asm volatile ("swi 0x2" : : "r" (r0) : "memory");  /* SWI_Write0 */
+  }
+#else
+#include <stdio.h>
+#include <string.h>
+
+static void
+put (const char *s) {
+  fputs (s, stdout);
+  }
+#endif
+
+#define GUARD	40
+#define MAXLEN	4099
+
+static unsigned char a[MAXLEN + 2 * GUARD];
+static unsigned char b[MAXLEN + 2 * GUARD];
+
+static const size_t long_lengths[] = {
+  96, 127, 128, 129, 255, 256, 257, 1000, 1024, 4096, MAXLEN
+  };
+
+static unsigned long seed;
+
+static void
+fill (unsigned char *p, size_t n) {
+  while (n--) {
+    seed = (seed * 1103515245 + 12345) & 0xffffffff;
+    *p++ = seed >> 16;
+    }
+  }
+
+static unsigned long
+hash (unsigned long h, const unsigned char *p, size_t n) {
+  while (n--)
+    h = ((h ^ *p++) * 16777619) & 0xffffffff;
+  return h;
+  }
+
+static unsigned long
+hash_word (unsigned long h, unsigned long w) {
+  unsigned char bytes[4];
+  bytes[0] = w, bytes[1] = w >> 8, bytes[2] = w >> 16, bytes[3] = w >> 24;
+  return hash (h, bytes, 4);
+  }
+
+static char *
+hex (char *s, unsigned long x, int digits) {
+  while (digits-- > 0)
+    *s++ = "0123456789abcdef"[(x >> (4 * digits)) & 15];
+  return s;
+  }
+
+static void
+report (const char *name, size_t n, unsigned long h) {
+  char line[40], *s = line;
+
+  while (*name)  *s++ = *name++;
+  *s++ = ' ';
+  s = hex (s, n, 4);
+  *s++ = ' ';
+  s = hex (s, h, 8);
+  *s++ = '\n';
+  *s = '\0';
+  put (line);
+  }
+
+static void
+check_memcpy (size_t n) {
+  unsigned long h = 2166136261ul;
+  int sa, da;
+
+  for (sa = 0; sa < 8; sa++)
+    for (da = 0; da < 8; da++) {
+      fill (a, sizeof a);
+      fill (b, sizeof b);
+      h = hash_word (h, memcpy (b + GUARD + da, a + GUARD + sa, n)
+			== b + GUARD + da);
+      h = hash (h, b, sizeof b);
+      }
+
+  report ("memcpy", n, h);
+  }
+
+static void
+check_memmove (size_t n) {
+  unsigned long h = 2166136261ul;
+  int delta;
+
+  for (delta = -GUARD; delta <= GUARD; delta++) {
+    fill (a, sizeof a);
+    h = hash_word (h, memmove (a + GUARD + delta, a + GUARD, n)
+		      == a + GUARD + delta);
+    h = hash (h, a, sizeof a);
+    }
+
+  report ("memmove", n, h);
+  }
+
+static void
+check_memset (size_t n) {
+  static const int values[] = { 0, 0x5a, 0xa5, 0x1ff, -1 };
+  unsigned long h = 2166136261ul;
+  int da, v;
+
+  for (da = 0; da < 8; da++)
+    for (v = 0; v < 5; v++) {
+      fill (b, sizeof b);
+      h = hash_word (h, memset (b + GUARD + da, values[v], n)
+			== b + GUARD + da);
+      h = hash (h, b, sizeof b);
+      }
+
+  report ("memset", n, h);
+  }
+
+static int
+sign (int x) {
+  return (x > 0) - (x < 0);
+  }
+
+static void
+check_memcmp (size_t n) {
+  unsigned long h = 2166136261ul;
+  int sa, da, k;
+
+  for (sa = 0; sa < 8; sa++)
+    for (da = 0; da < 8; da++) {
+      size_t diffs[4];
+      diffs[0] = 0, diffs[1] = n >> 1, diffs[2] = n - 1, diffs[3] = n;
+
+      for (k = 0; k < 4; k++) {
+	unsigned char *p = a + GUARD + sa, *q = b + GUARD + da;
+	fill (p, n);
+	memcpy (q, p, n);
+	if (diffs[k] < n) {
+	  /* Differ in both directions, including where only the top bit
+	     of the byte differs.  */
+	  q[diffs[k]] ^= (k & 1)? 0x80 : 0x01;
+	  h = hash_word (h, sign (memcmp (q, p, n)) + 1);
+	  }
+	h = hash_word (h, sign (memcmp (p, q, n)) + 1);
+	}
+      }
+
+  report ("memcmp", n, h);
+  }
+
+static void
+check_strlen (size_t n) {
+  unsigned long h = 2166136261ul;
+  int sa;
+
+  for (sa = 0; sa < 8; sa++) {
+    char *s = (char *) a + GUARD + sa;
+    size_t i;
+
+    /* Bytes that look like zeros to a careless word-at-a-time test.  */
+    for (i = 0; i < n; i++)
+      s[i] = (i & 1)? 0x80 : 0x01 + (i & 0x7e);
+    s[n] = '\0';
+    s[n + 1] = 0x01, s[n + 2] = 0x80, s[n + 3] = 0xff;
+    h = hash_word (h, strlen (s));
+    }
+
+  report ("strlen", n, h);
+  }
+
+static void
+check (size_t n) {
+  check_memcpy (n);
+  check_memmove (n);
+  check_memset (n);
+  check_memcmp (n);
+  check_strlen (n);
+  }
+
+int
+main () {
+  size_t n;
+
+  for (n = 0; n <= 80; n++)
+    check (n);
+  for (n = 0; n < sizeof long_lengths / sizeof long_lengths[0]; n++)
+    check (long_lengths[n]);
+
+  return 0;
+  }
@@ -0,0 +1,56 @@
+/* A native hot loop packaged as an armlet, to be run and timed on the host
+   with arm-palmos-run rather than on a device.  It checksums a buffer many
+   times, keeping the device awake via call68KFunc as a real long-running
+   armlet would, prints the checksum using the simulator's SWI_Write0, and
+   returns 0.  */
+
+#include <PalmOS.h>
+#include <PceNativeCall.h>
+#include <Standalone.h>
+
+STANDALONE_CODE_RESOURCE_ID (1000);
+
+#define BUFSIZE	4096
+#define PASSES	64
+
+static inline void
+put (const char *s) {
+  register const char *r0 asm ("r0") = s;
+  asm volatile ("swi 0x2" : : "r" (r0) : "memory");  /* SWI_Write0 */
+  }
+
+static UInt32
+fnv1a (UInt32 h, const UInt8 *p, UInt32 n) {
+  while (n--)
+    h = (h ^ *p++) * 16777619;
+  return h;
+  }
+
+UInt32
+start (const void *emulStateP, void *userData68KP,
+       Call68KFuncType *call68KFuncP) {
+  UInt8 buf[BUFSIZE];
+  UInt32 sum = 2166136261ul, i;
+  char line[10];
+
+  for (i = 0; i < BUFSIZE; i++)
+    buf[i] = i * 7 + (i >> 8);
+
+  for (i = 0; i < PASSES; i++) {
+    sum = fnv1a (sum, buf, BUFSIZE);
+    if ((i & 15) == 15)
+      (*call68KFuncP) (emulStateP,
+		       PceNativeTrapNo (sysTrapEvtResetAutoOffTimer), NULL, 0);
+    }
+
+  /* No string literals:  an armlet has no way to relocate their addresses.  */
+  for (i = 0; i < 8; i++) {
+    UInt32 digit = (sum >> (28 - 4 * i)) & 15;
+    line[i] = (digit < 10)? '0' + digit : 'a' + digit - 10;
+    }
+  line[8] = '\n';
+  line[9] = '\0';
+  put (line);
+
+  return 0;
+  }
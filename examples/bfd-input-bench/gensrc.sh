@@ -0,0 +1,35 @@
+#!/bin/sh
+# Generate OBJECTS assembler sources for loose objects and MEMBERS for the
+# members of an archive, as for a project linked against libraries split
+# into a function per member.  The loose objects refer to every member, so
+# that they are all pulled into the link.  Sections are small, so that even
+# a thousand or so of them fit in a 68000 code resource.
+# Usage: gensrc.sh DIR OBJECTS MEMBERS
+
+dir=$1
+objects=$2
+members=$3
+
+mkdir -p $dir
+
+awk -v dir=$dir -v objects=$objects -v members=$members 'BEGIN {
+  for (m = 1; m <= members; m++) {
+    out = dir "/lib" m ".s"
+    printf "\t.text\n\t.globl lib%d\nlib%d:\n", m, m > out
+    for (i = 0; i < 4; i++)
+      printf "\t.long %d\n", m * 4 + i > out
+    printf "\t.data\n\t.long %d\n", m > out
+    close (out)
+  }
+
+  for (f = 1; f <= objects; f++) {
+    out = dir "/m" f ".s"
+    printf "\t.text\n\t.globl m%d\nm%d:\n", f, f > out
+    for (i = 0; i < 8; i++)
+      printf "\t.long %d\n", f * 8 + i > out
+    printf "\t.data\n" > out
+    for (m = f; m <= members; m += objects)
+      printf "\t.long lib%d\n", m > out
+    close (out)
+  }
+}'
@@ -0,0 +1,44 @@
+// Compares calls per second for hot systraps called the normal way
+// (trap #15) and through the -mdirect-traps table.
+
+#include "bench.h"
+
+#define CALLS 20000
+
+static Int16 y = 10;
+
+static void Report( const char *label, UInt32 ticks )
+{
+    char line[64];
+    UInt32 perSec = (ticks > 0)? (UInt32) CALLS * SysTicksPerSecond() / ticks
+                               : 0;
+
+    StrPrintF( line, "%s: %lu calls/s", label, perSec );
+    WinDrawChars( line, StrLen(line), 5, y );
+    y += 12;
+}
+
+static void Time( const char *label, void (*loop)(UInt32) )
+{
+    UInt32 start = TimGetTicks();
+    loop( CALLS );
+    Report( label, TimGetTicks() - start );
+}
+
+UInt32 PilotMain( UInt16 cmd, void *cmdPBP, UInt16 launchFlags )
+{
+    EventType event;
+
+    if (cmd == sysAppLaunchCmdNormalLaunch) {
+        Time( "MemMove trap", MemMoveLoopTrap );
+        Time( "MemMove direct", MemMoveLoopDirect );
+        Time( "WinDrawChars trap", DrawCharsLoopTrap );
+        Time( "WinDrawChars direct", DrawCharsLoopDirect );
+
+        do {
+            EvtGetEvent( &event, evtWaitForever );
+            SysHandleEvent( &event );
+        } while (event.eType != appStopEvent);
+    }
+    return 0;
+}
@@ -0,0 +1,15 @@
+// Benchmark loops, compiled twice: once normally and once with
+// -mdirect-traps (which also defines DIRECT, to rename the functions).
+
+#include <PalmOS.h>
+
+#ifdef DIRECT
+#define LOOP(name) name##Direct
+#else
+#define LOOP(name) name##Trap
+#endif
+
+void MemMoveLoopTrap( UInt32 count );
+void MemMoveLoopDirect( UInt32 count );
+void DrawCharsLoopTrap( UInt32 count );
+void DrawCharsLoopDirect( UInt32 count );
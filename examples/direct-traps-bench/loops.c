@@ -0,0 +1,15 @@
+#include "bench.h"
+
+static char src[16], dst[16];
+
+void LOOP(MemMoveLoop)( UInt32 count )
+{
+    while (count-- > 0)
+        MemMove( dst, src, sizeof dst );
+}
+
+void LOOP(DrawCharsLoop)( UInt32 count )
+{
+    while (count-- > 0)
+        WinDrawChars( "x", 1, 0, 0 );
+}
@@ -0,0 +1,22 @@
+/* Write a reproducible stream of pseudo-random 16-bit words, for use
+   as a disassembler benchmark image.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int
+main (int argc, char **argv)
+{
+  unsigned long size = (argc > 1) ? strtoul (argv[1], NULL, 0) : 4194304;
+  unsigned long seed = 12345;
+  unsigned long i;
+
+  for (i = 0; i + 2 <= size; i += 2)
+    {
+      seed = (seed * 1103515245 + 12345) & 0xffffffff;
+      putchar ((seed >> 24) & 0xff);
+      putchar ((seed >> 16) & 0xff);
+    }
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#!/bin/sh
+# Generate m68k assembler sources with many relaxable branches:
+#   chain.s     N branches that each just reach past the next one, ending
+#               in one that cannot, so that growing it pushes the one
+#               before out of range, and so on back to the start
+#   blocks.s    N basic blocks of a large function, with conditional
+#               branches forward and back over varying distances
+#   stubs.s     N entry stubs that each branch to a common dispatcher,
+#               like libm's stubs but using relaxable jbra
+# Usage: gensrc.sh DIR N
+
+dir=$1
+n=$2
+
+mkdir -p $dir
+
+awk -v dir=$dir -v n=$n 'BEGIN {
+  # Branch i is at 64*i and targets 64*(i+2), so its byte displacement
+  # is 126 and it spans just the next branch; if that grows, branch i
+  # no longer reaches.  Only the last branch is out of range to begin
+  # with, so each pass over the frags can only grow one more.
+  out = dir "/chain.s"
+  printf "\t.text\n" > out
+  for (i = 0; i < n + 2; i++) {
+    if (i >= 2)
+      printf "t%d:\n", i - 2 > out
+    if (i < n - 1)
+      printf "b%d:\tjbne t%d\n", i, i > out
+    else if (i == n - 1)
+      printf "b%d:\tjbne far\n", i > out
+    else
+      printf "\tnop\n" > out
+    for (j = 0; j < 31; j++)
+      printf "\tnop\n" > out
+  }
+  printf "\t.skip 200\nfar:\trts\n" > out
+  close (out)
+
+  seed = 1
+  out = dir "/blocks.s"
+  printf "\t.text\n\t.even\n\t.globl big\nbig:\n" > out
+  for (i = 0; i < n; i++) {
+    printf "L%d:\tmove.l %%d%d,%%d%d\n", i, i % 8, (i + 3) % 8 > out
+    seed = (seed * 1103515245 + 12345) % 2147483648
+    len = int (seed / 65536) % 24
+    for (j = 0; j < len; j++)
+      printf "\taddq.l #%d,%%d%d\n", j % 8 + 1, j % 8 > out
+    seed = (seed * 1103515245 + 12345) % 2147483648
+    k = int (seed / 65536) % 400 - 150
+    if (i + k < 0 || i + k >= n)
+      k = -k
+    if (i + k >= 0 && i + k < n)
+      printf "\tjbeq L%d\n", i + k > out
+    if (i % 97 == 0)
+      printf "\tjbsr big\n" > out
+  }
+  printf "\trts\n" > out
+  close (out)
+
+  out = dir "/stubs.s"
+  printf "\t.text\n" > out
+  for (i = 1; i <= n; i++)
+    printf "\t.globl s%d\ns%d:\tmove.l #%d,%%d0\n\tjbra dispatch\n", i, i, i > out
+  printf "dispatch:\n\trts\n" > out
+  close (out)
+}'
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Generate FILES assembler sources with SECTIONS small sections each,
+# and a linker script that places every section with its own statement,
+# as a generated script for a large multi-section application would.
+# Usage: gensrc.sh DIR FILES SECTIONS
+
+dir=$1
+files=$2
+sections=$3
+
+mkdir -p $dir
+
+awk -v dir=$dir -v files=$files -v sections=$sections 'BEGIN {
+  for (f = 1; f <= files; f++) {
+    out = dir "/m" f ".s"
+    for (s = 1; s <= sections; s++) {
+      printf "\t.section sec%d,\"x\"\n", s > out
+      printf "f%d_s%d:\n\t.long %d, %d\n", f, s, f, s > out
+    }
+    close (out)
+  }
+
+  out = dir "/link.ld"
+  print "SECTIONS\n{" > out
+  for (s = 1; s <= sections; s++)
+    printf "  sec%d : { *(sec%d) }\n", s, s > out
+  print "  .data : { *(.data) }" > out
+  print "  .bss : { *(.bss) *(COMMON) }\n}" > out
+}'
@@ -0,0 +1,83 @@
+#!/bin/sh
+# Generate C sources shaped like a Palm OS application's event handling
+# code: lots of small handlers, each saving a few registers.
+#   handlers.c  N form event handlers and helpers in the .text section
+#   segment2.c  N/4 more, in a second code section as in a multiple
+#               code segment application
+# Only declarations are needed for the system calls, as the objects are
+# not linked into a complete application.
+# Usage: gensrc.sh DIR N
+
+dir=$1
+n=$2
+
+mkdir -p $dir
+
+awk -v dir=$dir -v n=$n '
+function header(out) {
+  printf "typedef unsigned char Boolean;\n" > out
+  printf "typedef struct { short eType; short x, y; short id; long data[4]; } Event;\n" > out
+  printf "typedef struct { short left, top, width, height; } Rect;\n\n" > out
+  printf "extern void *GetObjectPtr (short id);\n" > out
+  printf "extern void FldSetText (void *field, const char *text);\n" > out
+  printf "extern void FldDrawField (void *field);\n" > out
+  printf "extern void FrmDrawForm (void *form);\n" > out
+  printf "extern void *FrmGetActiveForm (void);\n" > out
+  printf "extern void WinDrawRectangle (const Rect *r, short corner);\n" > out
+  printf "extern short StrPrintF (char *s, const char *format, ...);\n" > out
+  printf "extern long Lookup (short table, short key);\n\n" > out
+}
+
+# A form event handler: a switch on the event type, with a call or two
+# in each case and a local buffer.
+function handler(out, i, attr) {
+  printf "Boolean%s\nHandler%d (Event *e)\n{\n", attr, i > out
+  printf "  Boolean handled = 0;\n  char buf[%d];\n  void *fld;\n\n", 8 + i % 5 * 4 > out
+  printf "  switch (e->eType)\n    {\n" > out
+  printf "    case 1:\n      FrmDrawForm (FrmGetActiveForm ());\n" > out
+  printf "      handled = 1;\n      break;\n" > out
+  printf "    case %d:\n      fld = GetObjectPtr (%d);\n", 2 + i % 3, 1000 + i > out
+  printf "      StrPrintF (buf, \"%%d/%%d\", e->x, e->y);\n" > out
+  printf "      FldSetText (fld, buf);\n      FldDrawField (fld);\n" > out
+  printf "      handled = 1;\n      break;\n" > out
+  if (i % 2 == 0) {
+    printf "    case 9:\n      if (e->id == %d)\n", 1000 + i > out
+    printf "        handled = Lookup (%d, e->data[0]) + Lookup (%d, e->data[1]) > e->x;\n", i, i > out
+    printf "      break;\n" > out
+  }
+  printf "    }\n\n  return handled;\n}\n\n" > out
+}
+
+# A drawing helper with a loop, which needs more registers.
+function drawer(out, i, attr) {
+  printf "void%s\nDraw%d (short count, short step)\n{\n", attr, i > out
+  printf "  Rect r;\n  short k;\n\n" > out
+  printf "  r.left = %d;\n  r.top = 0;\n  r.width = r.height = step;\n", i % 160 > out
+  printf "  for (k = 0; k < count; k++)\n    {\n" > out
+  printf "      WinDrawRectangle (&r, k & %d);\n", 1 + i % 3 > out
+  printf "      r.top += step;\n" > out
+  if (i % 3 == 0)
+    printf "      r.left += Lookup (%d, k) & 3;\n", i > out
+  printf "    }\n}\n\n" > out
+}
+
+BEGIN {
+  out = dir "/handlers.c"
+  header(out)
+  for (i = 0; i < n; i++) {
+    handler(out, i, "")
+    if (i % 2 == 0)
+      drawer(out, i, "")
+  }
+  close (out)
+
+  out = dir "/segment2.c"
+  header(out)
+  attr = " __attribute__ ((section (\"code2\")))"
+  for (i = n; i < n + n / 4; i++) {
+    handler(out, i, attr)
+    if (i % 2 == 0)
+      drawer(out, i, attr)
+  }
+  close (out)
+}'
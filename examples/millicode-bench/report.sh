@@ -0,0 +1,80 @@
+#!/bin/sh
+# Estimate the cost in cycles of -mmillicode, by comparing the assembler
+# output for the same source compiled with and without it.
+# Usage: report.sh PLAIN.s MILLICODE.s
+#
+# The extra cost per call of a function converted to millicode is the
+# time taken by the two bsr.w calls and the scratch register and frame
+# size handling in the routines: 50 clocks on entry and 42 on exit on a
+# 68000 with no wait states.  If a function's registers were rounded up
+# to a larger variant, each extra register costs 8 clocks to save and 8
+# more to restore.
+
+awk '
+function hex(s,  v, i, c) {
+  v = 0
+  s = tolower(substr(s, 3))
+  for (i = 1; i <= length(s); i++) {
+    c = index("0123456789abcdef", substr(s, i, 1)) - 1
+    v = v * 16 + c
+  }
+  return v
+}
+
+function bits(v,  n) {
+  for (n = 0; v > 0; v = int(v / 2))
+    n += v % 2
+  return n
+}
+
+# Function labels are the only labels that start in the first column
+# without a dot.
+/^[A-Za-z_][A-Za-z0-9_]*:$/ { fn = substr($0, 1, length($0) - 1); nrestored = 0; next }
+
+# In the plain output, count the registers restored just before unlk.
+FILENAME == ARGV[1] && /movm.l .*(%a6\)|\(%sp\)\+),#0x/ {
+  sub(/.*#/, ""); nrestored = bits(hex($0)); next
+}
+FILENAME == ARGV[1] && /move.l (-[0-9]+\(%a6\)|\(%sp\)\+),%(d[3-7]|a[2-4])$/ {
+  nrestored++; next
+}
+FILENAME == ARGV[1] && /unlk %a6/ { saved[fn] = nrestored; next }
+FILENAME == ARGV[1] { nrestored = 0; next }
+
+# In the millicode output, find the variant each converted function uses.
+/bsr.w (__frame_enter_|\.LME)/ { converted++; target[fn] = $2; next }
+
+# Local copies of the routines, for functions in named sections.
+/^\.LME[0-9]+:$/ { label = substr($0, 1, length($0) - 1); next }
+label != "" && /movm.l #0x/ {
+  sub(/.*#/, ""); sub(/,.*/, ""); local[label] = bits(hex($0)); label = ""
+}
+
+END {
+  for (fn in target) {
+    if (target[fn] ~ /^__frame_enter_/) {
+      variant = substr(target[fn], 15)
+      nregs = 0
+      if (match(variant, /d[3-7]/))
+        nregs += substr(variant, RSTART + 1, 1) - 2
+      if (match(variant, /a[2-4]/))
+        nregs += substr(variant, RSTART + 1, 1) - 1
+      used[variant]++
+    }
+    else {
+      nregs = local[target[fn]]
+      nlocal++
+    }
+    extra += nregs - saved[fn]
+  }
+
+  printf "%d functions converted\n", converted
+  for (v in used)
+    printf "  %4d using __frame_enter_%s\n", used[v], v
+  if (nlocal > 0)
+    printf "  %4d using local copies in named sections\n", nlocal
+  printf "%d registers saved beyond those needed, by rounding to a variant\n", extra
+  if (converted > 0)
+    printf "%d clocks added per call, on average (68000, no wait states)\n", \
+	   (92 * converted + 16 * extra) / converted
+}' "$@"
@@ -0,0 +1,8 @@
+// Main file for the generated project: it only needs to link.
+
+#include <PalmOS.h>
+
+UInt32 PilotMain( UInt16 cmd, void *cmdPBP, UInt16 launchFlags )
+{
+    return 0;
+}
@@ -0,0 +1,154 @@
+/* Check the libc record decoder against an uncompressed copy of the same
+   database, and time it.  This is built for the host, so it reads the
+   databases' big-endian headers itself rather than using the Data Manager.
+   Usage: decode-test PLAIN.pdb COMPRESSED.pdb  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "m68k/pdbcodec.h"
+
+struct pdb {
+  unsigned char *data;
+  unsigned long size;
+  unsigned int nrecs;
+  };
+
+static unsigned long
+get (const unsigned char *s, int n) {
+  unsigned long v = 0;
+  while (n-- > 0)
+    v = (v << 8) | *s++;
+  return v;
+  }
+
+static void
+load (const char *fname, struct pdb *db) {
+  FILE *f = fopen (fname, "rb");
+  long size;
+
+  if (f == NULL || fseek (f, 0, SEEK_END) != 0 || (size = ftell (f)) < 78) {
+    fprintf (stderr, "decode-test: can't read '%s'\n", fname);
+    exit (EXIT_FAILURE);
+    }
+
+  db->size = size;
+  db->data = malloc (size);
+  rewind (f);
+  if (db->data == NULL || fread (db->data, 1, size, f) != (size_t) size) {
+    fprintf (stderr, "decode-test: can't read '%s'\n", fname);
+    exit (EXIT_FAILURE);
+    }
+
+  fclose (f);
+  db->nrecs = get (db->data + 76, 2);
+  }
+
+static unsigned long
+entry_offset (const struct pdb *db, unsigned int i) {
+  return (i < db->nrecs)? get (db->data + 78 + 8 * i, 4) : db->size;
+  }
+
+static const unsigned char *
+record (const struct pdb *db, unsigned int i, unsigned long *lenP) {
+  unsigned long off = entry_offset (db, i);
+  *lenP = entry_offset (db, i + 1) - off;
+  return db->data + off;
+  }
+
+int
+main (int argc, char **argv) {
+  static unsigned char buf[65536];
+  struct pdb plain, packed;
+  const unsigned char *info, *dict;
+  unsigned long appinfo, lim, in_bytes = 0, out_bytes = 0, rounds;
+  unsigned int i, dictlen, bad = 0;
+  clock_t start, elapsed;
+
+  if (argc != 3) {
+    fprintf (stderr, "Usage: decode-test PLAIN.pdb COMPRESSED.pdb\n");
+    return EXIT_FAILURE;
+    }
+
+  load (argv[1], &plain);
+  load (argv[2], &packed);
+
+  appinfo = get (packed.data + 52, 4);
+  lim = get (packed.data + 56, 4);
+  if (lim == 0)
+    lim = entry_offset (&packed, 0);
+  info = packed.data + appinfo;
+  if (appinfo == 0 || lim - appinfo < 8
+      || get (info, 4) != PDB_CODEC_SIGNATURE
+      || get (info + 4, 2) != PDB_CODEC_VERSION
+      || lim - appinfo < 8 + get (info + 6, 2)) {
+    fprintf (stderr, "decode-test: '%s' is not compressed\n", argv[2]);
+    return EXIT_FAILURE;
+    }
+
+  dictlen = get (info + 6, 2);
+  dict = info + 8;
+
+  if (plain.nrecs != packed.nrecs) {
+    fprintf (stderr, "decode-test: record counts differ\n");
+    return EXIT_FAILURE;
+    }
+
+  for (i = 0; i < packed.nrecs; i++) {
+    unsigned long len, plainlen;
+    const unsigned char *rec = record (&packed, i, &len);
+    const unsigned char *orig = record (&plain, i, &plainlen);
+    Int32 n = pdb_decompress (dict, dictlen, rec, len, buf, sizeof buf);
+
+    if (n < 0 || (unsigned long) n != plainlen
+	|| pdb_decompressed_size (rec) != plainlen
+	|| memcmp (buf, orig, plainlen) != 0) {
+      if (bad++ < 10)
+	fprintf (stderr, "decode-test: record %u decodes wrongly\n", i);
+      }
+
+    in_bytes += len;
+    out_bytes += plainlen;
+    }
+
+  printf ("%u records, %lu bytes compressed to %lu + %u dictionary (%.1f%%)\n",
+	  packed.nrecs, out_bytes, in_bytes, dictlen,
+	  out_bytes? 100.0 * (in_bytes + dictlen) / out_bytes : 0.0);
+
+  /* Every record must also be rejected if its output buffer is too small,
+     rather than overrunning it.  */
+  for (i = 0; i < packed.nrecs; i++) {
+    unsigned long len, plainlen;
+    const unsigned char *rec = record (&packed, i, &len);
+    record (&plain, i, &plainlen);
+    if (plainlen > 0
+	&& pdb_decompress (dict, dictlen, rec, len, buf, plainlen - 1) != -1) {
+      if (bad++ < 10)
+	fprintf (stderr, "decode-test: record %u overran its buffer\n", i);
+      }
+    }
+
+  rounds = 0;
+  start = clock ();
+  do {
+    for (i = 0; i < packed.nrecs; i++) {
+      unsigned long len;
+      const unsigned char *rec = record (&packed, i, &len);
+      pdb_decompress (dict, dictlen, rec, len, buf, sizeof buf);
+      }
+    rounds++;
+    elapsed = clock () - start;
+    } while (elapsed < CLOCKS_PER_SEC);
+
+  printf ("decoded %.1f MB/s\n", (double) out_bytes * rounds
+	  / ((double) elapsed / CLOCKS_PER_SEC) / 1e6);
+
+  if (bad) {
+    printf ("%u errors\n", bad);
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+  }
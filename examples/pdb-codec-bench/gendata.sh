@@ -0,0 +1,37 @@
+#!/bin/sh
+# Generate a CSV data file of RECORDS text-heavy reference records, like
+# a gazetteer's: a place name, its region, and a formulaic description
+# drawn from a small vocabulary, as real reference data tends to be.
+# Usage: gendata.sh FILE RECORDS
+
+file=$1
+records=$2
+
+awk -v records=$records 'BEGIN {
+  srand (1)
+  nsyl = split ("an bel cor dun ell fen gar har ist jor kel lan mor nor " \
+		"ost pen ril sar tor ul ven wyn", syl)
+  nreg = split ("Northern Highlands|Southern Coast|Eastern Marches|" \
+		"Western Plains|Central Valley|Lake District|Border Country",
+		region, "|")
+  nkind = split ("village|market town|fishing port|hamlet|city|" \
+		 "river crossing|mining town", kind, "|")
+  nfeat = split ("a ruined abbey|an annual horse fair|a stone bridge|" \
+		 "the old lighthouse|its cheese market|a medieval castle|" \
+		 "the railway works|a famous brewery|its weekly fish market",
+		 feat, "|")
+
+  for (i = 0; i < records; i++) {
+    name = ""
+    for (n = 2 + int (rand () * 2); n > 0; n--)
+      name = name syl[1 + int (rand () * nsyl)]
+    name = toupper (substr (name, 1, 1)) substr (name, 2)
+
+    printf "%d,0,,%s,%s,\"A %s in the %s with a population of %d, " \
+	   "known for %s and %s.\"\n",
+	   i + 1, name, region[1 + int (rand () * nreg)],
+	   kind[1 + int (rand () * nkind)], region[1 + int (rand () * nreg)],
+	   100 + int (rand () * 50000), feat[1 + int (rand () * nfeat)],
+	   feat[1 + int (rand () * nfeat)]
+  }
+}' > $file
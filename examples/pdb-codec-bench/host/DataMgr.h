@@ -0,0 +1,13 @@
+/* Just enough of the Palm OS types for pdbcodec.c to compile on the host.  */
+
+#ifndef __DATAMGR_H__
+#define __DATAMGR_H__
+
+typedef unsigned char UInt8;
+typedef unsigned short UInt16;
+typedef unsigned int UInt32;
+typedef int Int32;
+typedef unsigned char Boolean;
+typedef void *DmOpenRef;
+
+#endif
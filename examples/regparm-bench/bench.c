@@ -0,0 +1,44 @@
+// Compares calls per second for small helpers that take their arguments
+// on the stack and the same helpers declared regparm.
+
+#include "bench.h"
+
+#define CALLS 20000
+
+static Int16 y = 10;
+
+static void Report( const char *label, UInt32 ticks )
+{
+    char line[64];
+    UInt32 perSec = (ticks > 0)? (UInt32) CALLS * SysTicksPerSecond() / ticks
+                               : 0;
+
+    StrPrintF( line, "%s: %lu calls/s", label, perSec );
+    WinDrawChars( line, StrLen(line), 5, y );
+    y += 12;
+}
+
+static void Time( const char *label, Int32 (*loop)(UInt32) )
+{
+    UInt32 start = TimGetTicks();
+    loop( CALLS );
+    Report( label, TimGetTicks() - start );
+}
+
+UInt32 PilotMain( UInt16 cmd, void *cmdPBP, UInt16 launchFlags )
+{
+    EventType event;
+
+    if (cmd == sysAppLaunchCmdNormalLaunch) {
+        Time( "Clamp stack", ClampLoopStack );
+        Time( "Clamp regparm", ClampLoopRegparm );
+        Time( "Plot stack", PixelLoopStack );
+        Time( "Plot regparm", PixelLoopRegparm );
+
+        do {
+            EvtGetEvent( &event, evtWaitForever );
+            SysHandleEvent( &event );
+        } while (event.eType != appStopEvent);
+    }
+    return 0;
+}
@@ -0,0 +1,17 @@
+// Benchmark loops, compiled twice: once normally and once with the
+// helpers they call declared regparm (which also renames the functions).
+
+#include <PalmOS.h>
+
+#ifdef REGPARM
+#define LOOP(name) name##Regparm
+#define CALLCONV __attribute__ ((regparm (3)))
+#else
+#define LOOP(name) name##Stack
+#define CALLCONV
+#endif
+
+Int32 ClampLoopStack( UInt32 count );
+Int32 ClampLoopRegparm( UInt32 count );
+Int32 PixelLoopStack( UInt32 count );
+Int32 PixelLoopRegparm( UInt32 count );
@@ -0,0 +1,37 @@
+#include "bench.h"
+
+static UInt8 frame[160];
+
+static Int16 CALLCONV Clamp( Int16 x, Int16 lo, Int16 hi )
+{
+    return (x < lo)? lo : (x > hi)? hi : x;
+}
+
+static void CALLCONV Plot( UInt8 *row, Int16 x, Int16 shade )
+{
+    row[x] = (UInt8) shade;
+}
+
+Int32 LOOP(ClampLoop)( UInt32 count )
+{
+    Int32 sum = 0;
+    Int16 x = 0;
+
+    while (count-- > 0) {
+        sum += Clamp( x, -100, 100 );
+        x += 37;
+    }
+    return sum;
+}
+
+Int32 LOOP(PixelLoop)( UInt32 count )
+{
+    Int16 x = 0;
+
+    while (count-- > 0) {
+        Plot( frame, x, x & 15 );
+        if (++x == sizeof frame)
+            x = 0;
+    }
+    return frame[0];
+}
@@ -0,0 +1,22 @@
+// Trap calls always pass their arguments on the stack, so the compiler
+// must reject regparm on a systrap or callseq function whichever order
+// the attributes are written in.  Compiled with and without REGPARM_FIRST.
+
+#include "bench.h"
+
+#ifdef REGPARM_FIRST
+Int32 Random1( Int32 seed )
+    __attribute__ ((regparm (1), systrap (sysTrapSysRandom)));
+Int32 Random2( Int32 seed )
+    __attribute__ ((regparm (1), callseq ("trap #15; dc.w 0xa0c7")));
+#else
+Int32 Random1( Int32 seed )
+    __attribute__ ((systrap (sysTrapSysRandom), regparm (1)));
+Int32 Random2( Int32 seed )
+    __attribute__ ((callseq ("trap #15; dc.w 0xa0c7"), regparm (1)));
+#endif
+
+Int32 Randoms( Int32 seed )
+{
+    return Random1( seed ) + Random2( seed );
+}
@@ -0,0 +1,20 @@
+// regparm is part of a method's type just as it is of a function's, so a
+// pointer to member function without it can't point at a regparm method.
+// The compiler must reject the initialization of stackCall.
+
+#include "bench.h"
+
+struct Accumulator
+{
+    Int32 total;
+
+    Int32 Add( Int32 n ) __attribute__ ((regparm (2)));
+};
+
+Int32 Accumulator::Add( Int32 n )
+{
+    return total += n;
+}
+
+__typeof__ (&Accumulator::Add) regparmCall = &Accumulator::Add;
+Int32 (Accumulator::*stackCall)( Int32 ) = &Accumulator::Add;
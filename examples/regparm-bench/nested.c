@@ -0,0 +1,17 @@
+// A nested function gets its static chain in a0, which regparm would also
+// use for its first pointer argument.  The compiler must reject this when
+// REGPARM is defined, rather than read BASE through P.
+
+#include "bench.h"
+
+Int16 Outer( Int16 *v, Int16 k )
+{
+    Int16 base = k * 3;
+
+    Int16 CALLCONV Add( Int16 *p, Int16 n )
+    {
+        return *p + n + base;
+    }
+
+    return Add( v, k );
+}
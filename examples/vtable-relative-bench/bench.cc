@@ -0,0 +1,62 @@
+// Times virtual calls through the widget hierarchy.  Build it with and
+// without -fvtable-relative and compare the calls per second, and the
+// data and rloc resources of the two applications.
+
+#include "widgets.h"
+
+#define CALLS 20000
+
+static Int16 y = 10;
+
+static void Report( const char *label, UInt32 value, const char *unit )
+{
+    char line[64];
+
+    StrPrintF( line, "%s: %lu %s", label, value, unit );
+    WinDrawChars( line, StrLen(line), 5, y );
+    y += 12;
+}
+
+static UInt32 TimeCalls( Widget **widgets )
+{
+    UInt32 start = TimGetTicks();
+    UInt32 sum = 0;
+
+    for (UInt32 i = 0; i < CALLS; i++) {
+        Widget *w = widgets[i % widgetKinds];
+        sum += w->Width() + w->HelpID();
+        if (w->HandleTap( (Int16) i & 127, 5 ))
+            sum++;
+    }
+
+    UInt32 ticks = TimGetTicks() - start;
+    return (ticks > 0)? (UInt32) CALLS * 4 * SysTicksPerSecond() / ticks : 0;
+}
+
+UInt32 PilotMain( UInt16 cmd, void *cmdPBP, UInt16 launchFlags )
+{
+    EventType event;
+
+    if (cmd == sysAppLaunchCmdNormalLaunch) {
+        Widget *widgets[widgetKinds];
+        UInt16 i;
+
+        for (i = 0; i < widgetKinds; i++)
+            widgets[i] = MakeWidget( i, i * 12 );
+
+#ifdef RELATIVE
+        Report( "Relative", TimeCalls( widgets ), "calls/s" );
+#else
+        Report( "Absolute", TimeCalls( widgets ), "calls/s" );
+#endif
+
+        do {
+            EvtGetEvent( &event, evtWaitForever );
+            SysHandleEvent( &event );
+        } while (event.eType != appStopEvent);
+
+        for (i = 0; i < widgetKinds; i++)
+            delete widgets[i];
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "widgets.h"
+
+void Widget::Draw( Int16 y ) const
+{
+    RectangleType r;
+    RctSetRectangle( &r, x_, y, Width(), Height() );
+    WinDrawRectangleFrame( simpleFrame, &r );
+}
+
+Boolean Widget::HandleTap( Int16 x, Int16 y )
+{
+    return Enabled() && x >= x_ && x < x_ + Width() && y >= 0 && y < Height();
+}
+
+#define DEFINE_WIDGET(Name, w, help)                    \
+Int16 Name::Width() const { return w; }                 \
+void Name::Draw( Int16 y ) const                        \
+{                                                       \
+    Widget::Draw( y );                                  \
+    WinDrawChars( #Name, sizeof #Name - 1, x_ + 2, y ); \
+}                                                       \
+Boolean Name::HandleTap( Int16 x, Int16 y )             \
+{                                                       \
+    return Widget::HandleTap( x, y ) && x != x_ + w;    \
+}                                                       \
+UInt16 Name::HelpID() const { return help; }
+
+DEFINE_WIDGET(Button, 36, 1000)
+DEFINE_WIDGET(PushButton, 20, 1001)
+DEFINE_WIDGET(Checkbox, 12, 1002)
+DEFINE_WIDGET(Label, 40, 1003)
+DEFINE_WIDGET(Field, 80, 1004)
+DEFINE_WIDGET(List, 60, 1005)
+DEFINE_WIDGET(Popup, 44, 1006)
+DEFINE_WIDGET(Slider, 70, 1007)
+DEFINE_WIDGET(Gadget, 16, 1008)
+DEFINE_WIDGET(ScrollBar, 7, 1009)
+DEFINE_WIDGET(Selector, 50, 1010)
+DEFINE_WIDGET(Table, 150, 1011)
+
+Widget* MakeWidget( UInt16 kind, Int16 x )
+{
+    switch (kind) {
+    case 0:  return new Button( x );
+    case 1:  return new PushButton( x );
+    case 2:  return new Checkbox( x );
+    case 3:  return new Label( x );
+    case 4:  return new Field( x );
+    case 5:  return new List( x );
+    case 6:  return new Popup( x );
+    case 7:  return new Slider( x );
+    case 8:  return new Gadget( x );
+    case 9:  return new ScrollBar( x );
+    case 10: return new Selector( x );
+    default: return new Table( x );
+    }
+}
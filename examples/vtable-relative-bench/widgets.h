@@ -0,0 +1,45 @@
+// A small class hierarchy with the kind of virtual interface a Palm OS
+// C++ application framework tends to have.
+
+#include <PalmOS.h>
+
+class Widget {
+public:
+    Widget( Int16 x ) : x_(x) {}
+    virtual ~Widget() {}
+    virtual Int16 Width() const = 0;
+    virtual Int16 Height() const { return 11; }
+    virtual void Draw( Int16 y ) const;
+    virtual Boolean HandleTap( Int16 x, Int16 y );
+    virtual Boolean Enabled() const { return true; }
+    virtual UInt16 HelpID() const { return 0; }
+
+protected:
+    Int16 x_;
+};
+
+#define DECLARE_WIDGET(Name)                            \
+class Name : public Widget {                            \
+public:                                                 \
+    Name( Int16 x ) : Widget(x) {}                      \
+    virtual Int16 Width() const;                        \
+    virtual void Draw( Int16 y ) const;                 \
+    virtual Boolean HandleTap( Int16 x, Int16 y );      \
+    virtual UInt16 HelpID() const;                      \
+};
+
+DECLARE_WIDGET(Button)
+DECLARE_WIDGET(PushButton)
+DECLARE_WIDGET(Checkbox)
+DECLARE_WIDGET(Label)
+DECLARE_WIDGET(Field)
+DECLARE_WIDGET(List)
+DECLARE_WIDGET(Popup)
+DECLARE_WIDGET(Slider)
+DECLARE_WIDGET(Gadget)
+DECLARE_WIDGET(ScrollBar)
+DECLARE_WIDGET(Selector)
+DECLARE_WIDGET(Table)
+
+Widget* MakeWidget( UInt16 kind, Int16 x );
+const UInt16 widgetKinds = 12;
@@ -3067,3 +3067,112 @@ SYM (__lesf2):
 	rts
 #endif /* L_lesf2 */
 
+/* Prologue and epilogue routines for -mmillicode.  A function calls
+   __frame_enter_NAME with `bsr.w' followed by a word giving the size of
+   its frame, and __frame_leave_NAME followed by a word giving the size
+   of its frame plus the registers saved; see output_millicode_call in
+   m68k.c.  Each variant saves %d3 up to some %dN and %a2 up to some %aN,
+   and is named after the last of each.  */
+
+#define FRAME_ROUTINES(name, regs)		\
+	.text					; \
+	.proc					; \
+	.globl	SYM (__frame_enter_ ## name)	; \
+	.globl	SYM (__frame_leave_ ## name)	; \
+SYM (__frame_enter_ ## name):			; \
+	movel	sp@+, a0			; \
+	linkw	a6, IMM (0)			; \
+	subaw	a0@+, sp			; \
+	moveml	regs, sp@-			; \
+	jmp	a0@				; \
+SYM (__frame_leave_ ## name):			; \
+	movel	sp@+, a1			; \
+	movel	a6, sp				; \
+	subaw	a1@, sp				; \
+	moveml	sp@+, regs			; \
+	unlk	a6				; \
+	rts
+
+#ifdef  L_frame_a3
+FRAME_ROUTINES (a3, a2-a3)
+#endif /* L_frame_a3 */
+
+#ifdef  L_frame_a4
+FRAME_ROUTINES (a4, a2-a4)
+#endif /* L_frame_a4 */
+
+#ifdef  L_frame_d3_a2
+FRAME_ROUTINES (d3_a2, d3/a2)
+#endif /* L_frame_d3_a2 */
+
+#ifdef  L_frame_d3_a3
+FRAME_ROUTINES (d3_a3, d3/a2-a3)
+#endif /* L_frame_d3_a3 */
+
+#ifdef  L_frame_d3_a4
+FRAME_ROUTINES (d3_a4, d3/a2-a4)
+#endif /* L_frame_d3_a4 */
+
+#ifdef  L_frame_d4
+FRAME_ROUTINES (d4, d3-d4)
+#endif /* L_frame_d4 */
+
+#ifdef  L_frame_d4_a2
+FRAME_ROUTINES (d4_a2, d3-d4/a2)
+#endif /* L_frame_d4_a2 */
+
+#ifdef  L_frame_d4_a3
+FRAME_ROUTINES (d4_a3, d3-d4/a2-a3)
+#endif /* L_frame_d4_a3 */
+
+#ifdef  L_frame_d4_a4
+FRAME_ROUTINES (d4_a4, d3-d4/a2-a4)
+#endif /* L_frame_d4_a4 */
+
+#ifdef  L_frame_d5
+FRAME_ROUTINES (d5, d3-d5)
+#endif /* L_frame_d5 */
+
+#ifdef  L_frame_d5_a2
+FRAME_ROUTINES (d5_a2, d3-d5/a2)
+#endif /* L_frame_d5_a2 */
+
+#ifdef  L_frame_d5_a3
+FRAME_ROUTINES (d5_a3, d3-d5/a2-a3)
+#endif /* L_frame_d5_a3 */
+
+#ifdef  L_frame_d5_a4
+FRAME_ROUTINES (d5_a4, d3-d5/a2-a4)
+#endif /* L_frame_d5_a4 */
+
+#ifdef  L_frame_d6
+FRAME_ROUTINES (d6, d3-d6)
+#endif /* L_frame_d6 */
+
+#ifdef  L_frame_d6_a2
+FRAME_ROUTINES (d6_a2, d3-d6/a2)
+#endif /* L_frame_d6_a2 */
+
+#ifdef  L_frame_d6_a3
+FRAME_ROUTINES (d6_a3, d3-d6/a2-a3)
+#endif /* L_frame_d6_a3 */
+
+#ifdef  L_frame_d6_a4
+FRAME_ROUTINES (d6_a4, d3-d6/a2-a4)
+#endif /* L_frame_d6_a4 */
+
+#ifdef  L_frame_d7
+FRAME_ROUTINES (d7, d3-d7)
+#endif /* L_frame_d7 */
+
+#ifdef  L_frame_d7_a2
+FRAME_ROUTINES (d7_a2, d3-d7/a2)
+#endif /* L_frame_d7_a2 */
+
+#ifdef  L_frame_d7_a3
+FRAME_ROUTINES (d7_a3, d3-d7/a2-a3)
+#endif /* L_frame_d7_a3 */
+
+#ifdef  L_frame_d7_a4
+FRAME_ROUTINES (d7_a4, d3-d7/a2-a4)
+#endif /* L_frame_d7_a4 */
@@ -34,6 +34,9 @@ Boston, MA 02111-1307, USA.  */
 #include "insn-attr.h"
 #include "recog.h"
 #include "toplev.h"
+#include "except.h"
+#include "function.h"
+#include "expr.h"
 
 /* Needed for use_return_insn.  */
 #include "flags.h"
@@ -207,6 +210,12 @@ palmos_valid_machine_decl_attribute (decl, attributes, attr, args)
 		 || TREE_CODE (trap_expr) == NON_LVALUE_EXPR)
 	    trap_expr = TREE_OPERAND (trap_expr, 0);
 
+	  if (palmos_regparm (TREE_TYPE (decl)) > 0)
+	    {
+	      error ("systrap functions must pass their arguments on the stack");
+	      return 0;
+	    }
+
 	  if (TREE_CODE (trap_expr) == INTEGER_CST)
 	    {
 	      char *name = IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (decl));
@@ -257,6 +266,12 @@ palmos_valid_machine_decl_attribute (decl, attributes, attr, args)
 	    if (warn)  warning ("possibly bad __callseq__ `%s'", fmt);
 	  }
 
+	  if (palmos_regparm (TREE_TYPE (decl)) > 0)
+	    {
+	      error ("callseq functions must pass their arguments on the stack");
+	      return 0;
+	    }
+
 	  prev = lookup_attribute ("callseq", attributes);
 	  if (prev != NULL_TREE
 	      && strcmp (TREE_STRING_POINTER (TREE_VALUE (TREE_VALUE (prev))),
@@ -291,6 +306,28 @@ palmos_valid_machine_decl_attribute (decl, attributes, attr, args)
 	{
 	  return (list_length (args) == 0);
 	}
+      else if (is_attribute_p ("regparm", attr))
+	{
+	  tree stack_attr;
+
+	  /* regparm is a type attribute, and is left for
+	     palmos_valid_machine_type_attribute to apply.  But if it
+	     follows systrap or callseq, they could not see it, so the
+	     conflict is caught here instead.  Claiming the attribute keeps
+	     it off the function's type.  */
+	  if (list_length (args) == 1
+	      && TREE_CODE (TREE_VALUE (args)) == INTEGER_CST
+	      && ! integer_zerop (TREE_VALUE (args))
+	      && ((stack_attr = lookup_attribute ("systrap", attributes))
+		  != NULL_TREE
+		  || (stack_attr = lookup_attribute ("callseq", attributes))
+		     != NULL_TREE))
+	    {
+	      error ("%s functions must pass their arguments on the stack",
+		     IDENTIFIER_POINTER (TREE_PURPOSE (stack_attr)));
+	      return 1;
+	    }
+	}
       break;
 
     default:
@@ -301,6 +338,163 @@ palmos_valid_machine_decl_attribute (decl, attributes, attr, args)
 }
 
 
+/* Return nonzero if ATTR is a valid attribute for TYPE.  The only one
+   is regparm (N), which says that the first N integer and pointer
+   arguments are passed in registers (see palmos_function_arg).  */
+int
+palmos_valid_machine_type_attribute (type, attributes, attr, args)
+     tree type;
+     tree attributes ATTRIBUTE_UNUSED;
+     tree attr;
+     tree args;
+{
+  if (TREE_CODE (type) != FUNCTION_TYPE
+      && TREE_CODE (type) != METHOD_TYPE
+      && TREE_CODE (type) != FIELD_DECL
+      && TREE_CODE (type) != TYPE_DECL)
+    return 0;
+
+  if (is_attribute_p ("regparm", attr))
+    {
+      tree cst;
+
+      if (list_length (args) != 1
+	  || TREE_CODE (cst = TREE_VALUE (args)) != INTEGER_CST
+	  || TREE_INT_CST_HIGH (cst) != 0
+	  || TREE_INT_CST_LOW (cst) > PALMOS_REGPARM_MAX)
+	{
+	  error ("regparm argument must be a constant between 0 and %d",
+		 PALMOS_REGPARM_MAX);
+	  return 0;
+	}
+
+      return 1;
+    }
+
+  return 0;
+}
+
+/* Return 0 if the attributes for two types are incompatible, 1 if they
+   are compatible.  Two function or method types are incompatible if they
+   pass different numbers of arguments in registers.  */
+int
+palmos_comp_type_attributes (type1, type2)
+     tree type1;
+     tree type2;
+{
+  if (TREE_CODE (type1) != FUNCTION_TYPE
+      && TREE_CODE (type1) != METHOD_TYPE)
+    return 1;
+
+  return palmos_regparm (type1) == palmos_regparm (type2);
+}
+
+/* Return the number of arguments that calls to functions of type FNTYPE
+   pass in registers.  Functions taking variable arguments always use
+   the stack, as va_arg expects.  */
+int
+palmos_regparm (fntype)
+     tree fntype;
+{
+  tree attr, param;
+
+  if (fntype == NULL_TREE
+      || (attr = lookup_attribute ("regparm", TYPE_ATTRIBUTES (fntype)))
+	 == NULL_TREE)
+    return 0;
+
+  for (param = TYPE_ARG_TYPES (fntype); param; param = TREE_CHAIN (param))
+    if (TREE_CHAIN (param) == NULL_TREE
+	&& TREE_VALUE (param) != void_type_node)
+      return 0;
+
+  return TREE_INT_CST_LOW (TREE_VALUE (TREE_VALUE (attr)));
+}
+
+/* Initialize CUM for a call to a function of type FNTYPE, which is 0 for
+   a library call.  */
+void
+palmos_init_cumulative_args (cum, fntype)
+     CUMULATIVE_ARGS *cum;
+     tree fntype;
+{
+  cum->nregs = palmos_regparm (fntype);
+  cum->dregs = 0;
+  cum->aregs = 0;
+}
+
+/* Likewise for the current function's own arguments, of type FNTYPE.
+   A nested function receives its static chain in %a0, which regparm
+   would also use for a pointer argument.  Callers can't tell that they
+   are calling a nested function when they call it through a pointer
+   (and its trampoline), so the two can't be separated; instead, regparm
+   is rejected for nested functions.  */
+void
+palmos_init_incoming_args (cum, fntype)
+     CUMULATIVE_ARGS *cum;
+     tree fntype;
+{
+  palmos_init_cumulative_args (cum, fntype);
+
+  if (cum->nregs > 0 && decl_function_context (current_function_decl))
+    {
+      error_with_decl (current_function_decl,
+		       "nested function `%s' cannot use `regparm'");
+      cum->nregs = 0;
+    }
+}
+
+/* Return the register in which to pass an argument of mode MODE and
+   type TYPE, or 0 to push it on the stack.  While CUM allows, integer
+   arguments are passed in d0, d1 and d2 and pointer arguments in a0 and
+   a1, the registers which the stack convention already treats as
+   call-clobbered.  Anything else, and anything that doesn't fit in the
+   remaining registers of its kind, goes on the stack as usual.  */
+struct rtx_def *
+palmos_function_arg (cum, mode, type, named)
+     CUMULATIVE_ARGS *cum;
+     enum machine_mode mode;
+     tree type;
+     int named;
+{
+  if (cum->nregs <= 0 || ! named || type == NULL_TREE
+      || mode == BLKmode || GET_MODE_SIZE (mode) > UNITS_PER_WORD)
+    return 0;
+
+  if (POINTER_TYPE_P (type))
+    {
+      if (cum->aregs < 2)
+	return gen_rtx_REG (mode, 8 + cum->aregs);
+    }
+  else if (INTEGRAL_TYPE_P (type))
+    {
+      if (cum->dregs < 3)
+	return gen_rtx_REG (mode, cum->dregs);
+    }
+
+  return 0;
+}
+
+/* Update CUM to advance past an argument of mode MODE and type TYPE.  */
+void
+palmos_function_arg_advance (cum, mode, type, named)
+     CUMULATIVE_ARGS *cum;
+     enum machine_mode mode;
+     tree type;
+     int named;
+{
+  rtx reg = palmos_function_arg (cum, mode, type, named);
+
+  if (reg)
+    {
+      cum->nregs--;
+      if (REGNO (reg) >= 8)
+	cum->aregs++;
+      else
+	cum->dregs++;
+    }
+}
+
 /* Encode DECL's section name into SYM's name as `@section|symname'.  */
 /* @@@ JWM fix the comment */
 void
@@ -450,24 +644,764 @@ output_extralogue (action, operand1)
     }
 }
 
+/* Systraps which have been called via the direct trap table (-mdirect-traps)
+   in this translation unit, one bit per vector from 0xA000 to 0xAFFF.  */
+static unsigned char direct_traps_used[0x1000 / 8];
+static int any_direct_traps_used;
+
+/* If the calling sequence ACTION is a plain systrap of the form
+   `trap #15; dc.w VECTOR', return VECTOR; otherwise return -1.  Anything
+   fancier (e.g., selector traps that load %d2 first) is left alone.  */
+static int
+plain_systrap_vector (action)
+     char *action;
+{
+  long vector;
+  int end = -1;
+
+  if (sscanf (action, " trap #15 ; dc.w %li %n", &vector, &end) < 1
+      || end < 0 || action[end] != '\0'
+      || vector < 0xA000 || vector > 0xAFFF)
+    return -1;
+
+  return vector;
+}
+
+/* Return a MEM for this translation unit's direct trap table slot for
+   VECTOR, which is filled in at startup by _GccResolveDirectTraps.  */
+static rtx
+direct_trap_slot (vector)
+     int vector;
+{
+  char name[16];
+
+  direct_traps_used[(vector - 0xA000) / 8] |= 1 << ((vector - 0xA000) % 8);
+  any_direct_traps_used = 1;
+
+  sprintf (name, "*__dtrap_%04x", vector);
+  return gen_rtx_MEM (Pmode,
+		      gen_rtx_PLUS (SImode,
+				    pic_offset_table_rtx,
+				    gen_rtx_SYMBOL_REF (SImode,
+				      IDENTIFIER_POINTER (get_identifier (name)))));
+}
+
 void
 output_callseq (operand1)
      rtx operand1;
 {
-  rtx operands[2];
+  rtx operands[3];
   char *encoded_name = XSTR (operand1, 0);
   char *action = alloca (strlen (encoded_name+1) + 1);
+  int vector;
 
   strcpy (action, encoded_name+1);
   *index (action, '\036') = '\0';
 
   operands[0] = operand1;
   operands[1] = pic_offset_table_rtx;
+
+  /* %a0 is free here: arguments are all on the stack and it's call-used.  */
+  if (TARGET_DIRECT_TRAPS && (vector = plain_systrap_vector (action)) >= 0)
+    {
+      operands[2] = direct_trap_slot (vector);
+      output_asm_insn ("move.l %2,%%a0\n\tjsr (%%a0)", operands);
+      return;
+    }
+
   app_enable ();
   output_asm_insn (action, operands);
   app_disable ();
 }
 
+/* -mmillicode replaces the link/movem.l prologue and movem.l/unlk/rts
+   epilogue of a function that saves two or more registers with a call to
+   a shared routine followed by a word of frame size:
+
+	bsr.w __frame_enter_d5_a3	bsr.w __frame_leave_d5_a3
+	.word FSIZE			.word FSIZE + 4 * NREGS
+
+   The routine builds or tears down the same frame as the inline code
+   would, so the rest of the function is unchanged.  Each variant saves
+   %d3 up to some %dN and %a2 up to some %aN, so a function's register
+   mask is rounded up to the nearest variant.  Functions in the .text
+   section use the variants in libgcc; a function in a named section
+   can't reach those with bsr.w, so it uses local copies, which are
+   emitted once per section per translation unit at the end of the file.
+
+   Entry uses %a0 and exit %a1 as scratch registers, so functions that
+   may receive arguments or a static chain in those are left alone.  */
+
+struct millicode_use
+{
+  struct millicode_use *next;
+  char *section;
+  int variant;
+  int labelno;
+};
+
+static struct millicode_use *millicode_uses;
+static int millicode_labelno;
+
+#define MILLICODE_DREGS(VARIANT)  ((VARIANT) / 4)
+#define MILLICODE_AREGS(VARIANT)  ((VARIANT) % 4)
+
+/* Return the millicode variant that the current function, with a frame
+   of FSIZE bytes, should use to save and restore its registers, or -1
+   if it should have an inline prologue and epilogue.  */
+static int
+millicode_variant (fsize)
+     int fsize;
+{
+  extern char call_used_regs[];
+  int regno, nregs = 0, dregs = 0, aregs = 0;
+
+  if (! TARGET_MILLICODE || ! frame_pointer_needed
+      || TARGET_5200 || TARGET_DEBUG_LABELS
+      || current_function_needs_context || current_function_pops_args
+      || palmos_regparm (TREE_TYPE (current_function_decl)) != 0
+      || dwarf2out_do_frame ())
+    return -1;
+
+  if (flag_pic && TARGET_PCREL)
+    {
+      if (TARGET_EXTRALOGUES
+	  && lookup_attribute ("extralogue",
+			       DECL_MACHINE_ATTRIBUTES (current_function_decl)))
+	return -1;
+    }
+  else if (flag_pic && current_function_uses_pic_offset_table)
+    return -1;
+
+  if (TARGET_68881)
+    for (regno = 16; regno < 24; regno++)
+      if (regs_ever_live[regno] && ! call_used_regs[regno])
+	return -1;
+
+  for (regno = 0; regno < 16; regno++)
+    if (regno != FRAME_POINTER_REGNUM
+	&& ((regs_ever_live[regno] && ! call_used_regs[regno])
+	    || EXTRA_REGISTER_SAVE (regno)))
+      {
+	if (regno >= 3 && regno <= 7)
+	  dregs = regno - 2;
+	else if (regno >= 10 && regno <= 12)
+	  aregs = regno - 9;
+	else
+	  return -1;
+	nregs++;
+      }
+
+  /* With fewer registers, the inline code is as small or nearly so.  */
+  if (nregs < 2 || fsize + 4 * (dregs + aregs) >= 0x8000)
+    return -1;
+
+  return dregs * 4 + aregs;
+}
+
+/* Write the name of millicode VARIANT to BUF, e.g., "d5_a3" for the one
+   that saves %d3-%d5/%a2-%a3.  */
+static void
+millicode_name (buf, variant)
+     char *buf;
+     int variant;
+{
+  int dregs = MILLICODE_DREGS (variant), aregs = MILLICODE_AREGS (variant);
+
+  if (dregs && aregs)
+    sprintf (buf, "d%d_a%d", dregs + 2, aregs + 1);
+  else if (dregs)
+    sprintf (buf, "d%d", dregs + 2);
+  else
+    sprintf (buf, "a%d", aregs + 1);
+}
+
+/* Return the movem.l register mask for millicode VARIANT, in the order
+   used by the predecrement form if PREDEC.  */
+static int
+millicode_mask (variant, predec)
+     int variant, predec;
+{
+  int mask = 0, i;
+
+  for (i = 0; i < MILLICODE_DREGS (variant); i++)
+    mask |= 1 << (3 + i);
+  for (i = 0; i < MILLICODE_AREGS (variant); i++)
+    mask |= 1 << (10 + i);
+
+  if (predec)
+    {
+      int rmask = 0;
+      for (i = 0; i < 16; i++)
+	if (mask & (1 << i))
+	  rmask |= 1 << (15 - i);
+      mask = rmask;
+    }
+
+  return mask;
+}
+
+/* Output a call to the entry (if ENTER) or exit routine of millicode
+   VARIANT, followed by the frame size word ARG.  */
+static void
+output_millicode_call (stream, variant, enter, arg)
+     FILE *stream;
+     int variant, enter, arg;
+{
+  tree section = DECL_SECTION_NAME (current_function_decl);
+  char name[16];
+
+  if (section == NULL_TREE)
+    {
+      millicode_name (name, variant);
+      asm_fprintf (stream, "\tbsr.w %U__frame_%s_%s\n",
+		   enter ? "enter" : "leave", name);
+    }
+  else
+    {
+      struct millicode_use *use;
+      char *section_name = TREE_STRING_POINTER (section);
+      char label[32];
+
+      for (use = millicode_uses; use; use = use->next)
+	if (use->variant == variant && strcmp (use->section, section_name) == 0)
+	  break;
+
+      if (use == NULL)
+	{
+	  use = (struct millicode_use *) xmalloc (sizeof *use);
+	  use->section = xstrdup (section_name);
+	  use->variant = variant;
+	  use->labelno = millicode_labelno++;
+	  use->next = millicode_uses;
+	  millicode_uses = use;
+	}
+
+      ASM_GENERATE_INTERNAL_LABEL (label, enter ? "LME" : "LML",
+				   use->labelno);
+      fprintf (stream, "\tbsr.w ");
+      assemble_name (stream, label);
+      fprintf (stream, "\n");
+    }
+
+  fprintf (stream, "\t.word %d\n", arg);
+}
+
+/* If the current function should use millicode for its prologue, output
+   it and return 1.  FSIZE is the size of the frame.  */
+static int
+output_millicode_prologue (stream, fsize)
+     FILE *stream;
+     int fsize;
+{
+  int variant = millicode_variant (fsize);
+
+  if (variant < 0)
+    return 0;
+
+  output_millicode_call (stream, variant, 1, fsize);
+  return 1;
+}
+
+/* Likewise for the epilogue, which returns from the function too.  */
+static int
+output_millicode_epilogue (stream, fsize)
+     FILE *stream;
+     int fsize;
+{
+  int variant = millicode_variant (fsize);
+
+  if (variant < 0)
+    return 0;
+
+  output_millicode_call (stream, variant, 0,
+			 fsize + 4 * (MILLICODE_DREGS (variant)
+				      + MILLICODE_AREGS (variant)));
+  return 1;
+}
+
+/* Output the local copies of the millicode routines used by functions
+   in named sections.  These match the libgcc ones in lb1sf68palmos.asm:
+   entry pops the address of the frame size word into %a0 and returns
+   past it, and exit pops it into %a1 and returns from the function.  */
+static void
+output_millicode_routines (stream)
+     FILE *stream;
+{
+  struct millicode_use *use;
+
+  for (use = millicode_uses; use; use = use->next)
+    {
+      fprintf (stream, "\t.section\t%s,\"x\"\n\t.even\n", use->section);
+
+      ASM_OUTPUT_INTERNAL_LABEL (stream, "LME", use->labelno);
+      asm_fprintf (stream, "\tmove.l (%Rsp)+,%Ra0\n");
+      asm_fprintf (stream, "\tlink.w %s,%0I0\n",
+		   reg_names[FRAME_POINTER_REGNUM]);
+      asm_fprintf (stream, "\tsuba.w (%Ra0)+,%Rsp\n");
+      asm_fprintf (stream, "\tmovm.l %0I0x%x,-(%Rsp)\n",
+		   millicode_mask (use->variant, 1));
+      asm_fprintf (stream, "\tjmp (%Ra0)\n");
+
+      ASM_OUTPUT_INTERNAL_LABEL (stream, "LML", use->labelno);
+      asm_fprintf (stream, "\tmove.l (%Rsp)+,%Ra1\n");
+      asm_fprintf (stream, "\tmove.l %s,%Rsp\n",
+		   reg_names[FRAME_POINTER_REGNUM]);
+      asm_fprintf (stream, "\tsuba.w (%Ra1),%Rsp\n");
+      asm_fprintf (stream, "\tmovm.l (%Rsp)+,%0I0x%x\n",
+		   millicode_mask (use->variant, 0));
+      asm_fprintf (stream, "\tunlk %s\n\trts\n",
+		   reg_names[FRAME_POINTER_REGNUM]);
+    }
+}
+
+/* Emit this translation unit's direct trap table entries.  Each is a
+   trap vector followed by a slot for its address; the linker gathers all
+   the `dtraps' sections between dtraps_start and dtraps_end in the data
+   section, where crt0 can find them.  Also emit any local copies of
+   millicode routines needed by -mmillicode.  */
+void
+palmos_asm_file_end (stream)
+     FILE *stream;
+{
+  int i;
+
+  output_millicode_routines (stream);
+
+  if (! any_direct_traps_used)
+    return;
+
+  fprintf (stream, "\t.section\tdtraps,\"d\"\n\t.even\n");
+  for (i = 0; i < 0x1000; i++)
+    if (direct_traps_used[i / 8] & (1 << (i % 8)))
+      fprintf (stream, "\t.word\t0x%04x\n__dtrap_%04x:\n\t.long\t0\n",
+	       0xA000 + i, 0xA000 + i);
+}
+
+
+/* -mtune= setting.  The DragonBall cores (MC68328, EZ, VZ) are 68EC000
+   derivatives with the 68000's instruction timings, but they differ from
+   each other in how many wait states a bus cycle typically costs.  */
+const char *palmos_tune_string;
+int palmos_tune_dragonball;
+static int palmos_tune_wait_states;
+
+void
+palmos_select_tune ()
+{
+  if (palmos_tune_string == NULL || strcmp (palmos_tune_string, "68000") == 0)
+    palmos_tune_dragonball = 0;
+  else if (strcmp (palmos_tune_string, "dragonball") == 0)
+    {
+      /* MC68328 and EZ devices run from DRAM with one wait state.  */
+      palmos_tune_dragonball = 1;
+      palmos_tune_wait_states = 1;
+    }
+  else if (strcmp (palmos_tune_string, "dragonball-vz") == 0)
+    {
+      /* VZ devices have SDRAM which usually needs no wait states.  */
+      palmos_tune_dragonball = 1;
+      palmos_tune_wait_states = 0;
+    }
+  else
+    error ("bad value (%s) for -mtune= switch", palmos_tune_string);
+}
+
+/* Convert a DragonBall timing into a cost.  BUS is the number of clocks
+   spent in bus cycles (four per word transferred, which get stretched
+   by any wait states) and INTERNAL is the number of clocks the core is
+   busy otherwise.  The result is in units of two clocks, so that eight
+   clocks -- an add.l between registers -- is 4, the same as a typical
+   single instruction in the generic cost model.  */
+static int
+dragonball_cost (bus, internal)
+     int bus, internal;
+{
+  int clocks = bus + bus / 4 * palmos_tune_wait_states + internal;
+  return (clocks + 1) / 2;
+}
+
+/* Return the number of bus clocks needed to fetch or store an operand of
+   mode MODE through address ADDR, including any extension words.  */
+static int
+dragonball_address_clocks (addr, mode)
+     rtx addr;
+     enum machine_mode mode;
+{
+  int extra = (GET_MODE_SIZE (mode) > 2)? 4 : 0;
+
+  switch (GET_CODE (addr))
+    {
+    case REG:
+    case POST_INC:
+      return 4 + extra;
+
+    case PRE_DEC:
+      return 6 + extra;
+
+    case PLUS:
+      if (CONSTANT_P (XEXP (addr, 1))
+	  && (GET_CODE (XEXP (addr, 0)) == REG || XEXP (addr, 0) == pc_rtx))
+	return 8 + extra;	/* d16(An), d16(PC), including sym@END(%a5) */
+      return 10 + extra;	/* d8(An,Xn) */
+
+    case CONST_INT:
+      if (INTVAL (addr) >= -0x8000 && INTVAL (addr) <= 0x7fff)
+	return 8 + extra;	/* abs.w */
+      /* Fall through.  */
+    default:
+      return 12 + extra;	/* abs.l */
+    }
+}
+
+/* Return the number of bus clocks needed to fetch or store an operand X
+   of mode MODE, including any extension words, from the effective address
+   calculation times in the MC68000 User's Manual.  Returns -1 if X is not
+   something that fits in an effective address.  */
+static int
+dragonball_operand_clocks (x, mode)
+     rtx x;
+     enum machine_mode mode;
+{
+  int extra = (GET_MODE_SIZE (mode) > 2)? 4 : 0;
+
+  switch (GET_CODE (x))
+    {
+    case REG:
+    case SUBREG:
+      return 0;
+
+    case CONST_INT:
+      if (INTVAL (x) >= 1 && INTVAL (x) <= 8)
+	return 0;  /* Assume we'll get a quick form.  */
+      /* Fall through.  */
+    case CONST_DOUBLE:
+    case CONST:
+    case SYMBOL_REF:
+    case LABEL_REF:
+      return 4 + extra;
+
+    case MEM:
+      return dragonball_address_clocks (XEXP (x, 0), mode);
+
+    default:
+      return -1;
+    }
+}
+
+/* The cost of operand X as part of a larger expression with code
+   OUTER_CODE: its effective address cost if it has one, and otherwise
+   whatever it costs to compute it into a register first.  */
+static int
+dragonball_operand_cost (x, outer_code)
+     rtx x;
+     enum rtx_code outer_code;
+{
+  int clocks = dragonball_operand_clocks (x, GET_MODE (x));
+  if (clocks >= 0)
+    return dragonball_cost (clocks, 0);
+  return rtx_cost (x, outer_code);
+}
+
+/* RTX_COSTS for -mtune=dragonball*.  Each case is the 68000 timing for
+   the instruction(s) m68k.md emits for that code on a register operand
+   (from the MC68000 User's Manual, section 8), plus the cost of the
+   operands.  Multiplies and divides that aren't 16-bit are libcalls, and
+   the figures for those are typical path lengths through lb1sf68palmos.  */
+int
+palmos_rtx_costs (x, code, outer_code)
+     rtx x;
+     enum rtx_code code;
+     enum rtx_code outer_code ATTRIBUTE_UNUSED;
+{
+  enum machine_mode mode = GET_MODE (x);
+  int wide = GET_MODE_SIZE (mode) > 2;
+  rtx op0 = XEXP (x, 0);
+  rtx op1 = (GET_RTX_LENGTH (code) > 1)? XEXP (x, 1) : NULL_RTX;
+  int ops;
+
+  switch (code)
+    {
+    case MEM:
+      return dragonball_cost (dragonball_operand_clocks (x, mode), 0);
+
+    case PLUS:
+    case MINUS:
+    case AND:
+    case IOR:
+    case XOR:
+      ops = dragonball_operand_cost (op0, code);
+      if ((code == PLUS || code == MINUS) && GET_CODE (op1) == CONST_INT)
+	{
+	  int n = INTVAL (op1);
+
+	  if (n >= -8 && n <= 8)
+	    return dragonball_cost (wide? 8 : 4, 0) + ops;	/* addq/subq */
+	  /* lea d16(An) for address registers, add.l #imm otherwise.  */
+	  if (n >= -0x8000 && n <= 0x7fff)
+	    return dragonball_cost (wide? 12 : 8, 0) + ops;
+	}
+      return dragonball_cost (wide? 8 : 4, 0) + ops
+	     + dragonball_operand_cost (op1, code);
+
+    case NEG:
+    case NOT:
+      return dragonball_cost (wide? 6 : 4, 0)
+	     + dragonball_operand_cost (op0, code);
+
+    case SIGN_EXTEND:
+      return dragonball_cost (4, 0) + dragonball_operand_cost (op0, code);
+
+    case ZERO_EXTEND:
+      /* moveq #0; move.[bw] */
+      return dragonball_cost (8, 0) + dragonball_operand_cost (op0, code);
+
+    case ASHIFT:
+    case ASHIFTRT:
+    case LSHIFTRT:
+    case ROTATE:
+    case ROTATERT:
+      ops = dragonball_operand_cost (op0, code);
+      if (GET_CODE (op1) == CONST_INT)
+	{
+	  int n = INTVAL (op1);
+
+	  if (code == ASHIFT && n == 1)
+	    return dragonball_cost (wide? 8 : 4, 0) + ops;	/* add Dn,Dn */
+	  if (wide && n == 16 && code != ROTATE && code != ROTATERT)
+	    return dragonball_cost (8, 0) + ops;	/* swap; clr.w/ext.l */
+	  if (n <= 8)
+	    return dragonball_cost (wide? 8 : 6, 2 * n) + ops;
+	  /* moveq #n,Dx; lsX Dx,Dn */
+	  return dragonball_cost (4 + (wide? 8 : 6), 2 * n) + ops;
+	}
+      /* Variable count: assume it's typically around half the width.  */
+      return dragonball_cost (wide? 8 : 6, wide? 32 : 16) + ops
+	     + dragonball_operand_cost (op1, code);
+
+    case MULT:
+      /* Don't cost a multiply by a power of two as the shift it will
+	 become: expand_mult only synthesizes a shift sequence when that
+	 is cheaper than the multiply itself.  */
+      if (! wide
+	  || ((GET_CODE (op0) == SIGN_EXTEND || GET_CODE (op0) == ZERO_EXTEND)
+	      && mode == SImode))
+	{
+	  /* muls.w/mulu.w take 38 clocks plus 2 per bit pattern
+	     transition or set bit, up to 70.  */
+	  if (GET_CODE (op0) == SIGN_EXTEND || GET_CODE (op0) == ZERO_EXTEND)
+	    op0 = XEXP (op0, 0);
+	  if (GET_CODE (op1) == SIGN_EXTEND || GET_CODE (op1) == ZERO_EXTEND)
+	    op1 = XEXP (op1, 0);
+	  return dragonball_cost (4, 50)
+		 + dragonball_operand_cost (op0, code)
+		 + dragonball_operand_cost (op1, code);
+	}
+      /* __mulsi3: three mulu.w plus the call and glue.  */
+      return dragonball_cost (80, 170);
+
+    case DIV:
+    case UDIV:
+    case MOD:
+    case UMOD:
+      if (! wide)
+	return dragonball_cost (8, (code == DIV || code == MOD)? 150 : 132)
+	       + dragonball_operand_cost (op0, code)
+	       + dragonball_operand_cost (op1, code);
+      /* A 32/16 division is open-coded as two divu.w (see
+	 output_divmodsi_hi); otherwise it's __divsi3 and friends, which
+	 take the same fast path or else a shift and subtract loop.  */
+      if (GET_CODE (op1) == CONST_INT
+	  && m68k_hi_divisor (op1, code == UDIV || code == UMOD))
+	return dragonball_cost (40, 270) + dragonball_operand_cost (op0, code);
+      return dragonball_cost (100, 400);
+
+    default:
+      return -1;
+    }
+}
+
+/* ADDRESS_COST for -mtune=dragonball*: the time to fetch a word through
+   address X.  */
+int
+palmos_address_cost (x)
+     rtx x;
+{
+  return dragonball_cost (dragonball_address_clocks (x, HImode), 0);
+}
+
+/* -mpalmos-builtins.  Block moves, clears and compares (from memcpy,
+   memset, memcmp and structure copies) of a known length are open-coded
+   when short.  Long blocks are moved and set by the MemMove and MemSet
+   traps, which only make up for their dispatch overhead on long runs;
+   anything in between, or of unknown length, goes to the libc routines.  */
+#define PALMOS_BLOCK_INLINE_MAX		(optimize_size ? 16 : 64)
+#define PALMOS_BLOCK_TRAP_MIN		256
+#define PALMOS_CMPMEM_INLINE_MAX	16
+
+#define sysTrapMemMove	0xa026
+#define sysTrapMemSet	0xa027
+
+/* Return a symbol_ref which calls systrap VECTOR, encoded as for a
+   function with a callseq attribute.  */
+static rtx
+palmos_systrap_symbol (vector, name)
+     int vector;
+     char *name;
+{
+  char *coding = alloca (32 + strlen (name));
+
+  sprintf (coding, "=trap #15; dc.w 0x%04x\036%s", vector, name);
+  return gen_rtx_SYMBOL_REF (Pmode, IDENTIFIER_POINTER (get_identifier (coding)));
+}
+
+/* Return the number of bytes which can be open-coded for a block of LENGTH
+   bytes whose addresses are aligned to ALIGN bytes.  Without word alignment
+   we must go a byte at a time, so there is less to be gained.  */
+static int
+palmos_block_inline_p (length, align)
+     rtx length;
+     int align;
+{
+  int max = PALMOS_BLOCK_INLINE_MAX;
+
+  if (GET_CODE (length) != CONST_INT)
+    return 0;
+
+  if (align < 2)
+    max /= 4;
+
+  return INTVAL (length) > 0 && INTVAL (length) <= max;
+}
+
+static int
+palmos_block_trap_p (length)
+     rtx length;
+{
+  return GET_CODE (length) == CONST_INT
+	 && INTVAL (length) >= PALMOS_BLOCK_TRAP_MIN;
+}
+
+/* Expand a block move (movstrsi) of OPERANDS[2] bytes from OPERANDS[1]
+   to OPERANDS[0].  Return 0 if we'd rather it was passed to memcpy.  */
+int
+palmos_expand_movstr (operands)
+     rtx *operands;
+{
+  int align = INTVAL (operands[3]);
+
+  if (palmos_block_inline_p (operands[2], align))
+    {
+      rtx dst = copy_to_mode_reg (Pmode, XEXP (operands[0], 0));
+      rtx src = copy_to_mode_reg (Pmode, XEXP (operands[1], 0));
+
+      emit_insn (gen_palmos_movstr (dst, src, operands[2], operands[3]));
+      return 1;
+    }
+  else if (palmos_block_trap_p (operands[2]))
+    {
+      emit_library_call (palmos_systrap_symbol (sysTrapMemMove, "MemMove"),
+			 0, VOIDmode, 3,
+			 XEXP (operands[0], 0), Pmode,
+			 XEXP (operands[1], 0), Pmode,
+			 convert_to_mode (SImode, operands[2], 1), SImode);
+      return 1;
+    }
+
+  return 0;
+}
+
+/* Expand a block set of OPERANDS[1] bytes at OPERANDS[0] to the byte
+   VALUE.  Return 0 if we'd rather it was passed to memset.  */
+int
+palmos_expand_setstr (operands, value)
+     rtx *operands;
+     rtx value;
+{
+  int align = INTVAL (operands[2]);
+
+  if (GET_CODE (value) == CONST_INT
+      && palmos_block_inline_p (operands[1], align))
+    {
+      rtx dst = copy_to_mode_reg (Pmode, XEXP (operands[0], 0));
+
+      emit_insn (gen_palmos_setstr (dst, operands[1], operands[2],
+				    GEN_INT (INTVAL (value) & 0xff)));
+      return 1;
+    }
+  else if (palmos_block_trap_p (operands[1]))
+    {
+      /* MemSet's UInt8 value is passed in a byte of its own.  */
+      emit_library_call (palmos_systrap_symbol (sysTrapMemSet, "MemSet"),
+			 0, VOIDmode, 3,
+			 XEXP (operands[0], 0), Pmode,
+			 convert_to_mode (SImode, operands[1], 1), SImode,
+			 convert_to_mode (QImode, value, 1), QImode);
+      return 1;
+    }
+
+  return 0;
+}
+
+/* Expand the builtin memset (DEST_MEM, VAL, LEN) when VAL is not zero;
+   zero fills go through clear_storage and clrstrsi instead.  Return the
+   destination address, or 0 to call memset after all.  */
+rtx
+palmos_expand_memset (dest_mem, val, len, align)
+     rtx dest_mem;
+     rtx val;
+     rtx len;
+     int align;
+{
+  rtx operands[3];
+
+  if (val == const0_rtx)
+    return 0;
+
+  operands[0] = dest_mem;
+  operands[1] = len;
+  operands[2] = GEN_INT (align);
+
+  if (! palmos_expand_setstr (operands, val))
+    return 0;
+
+  return force_operand (XEXP (dest_mem, 0), NULL_RTX);
+}
+
+/* Expand a block compare (cmpstrsi) of OPERANDS[3] bytes at OPERANDS[1]
+   and OPERANDS[2] into OPERANDS[0].  The expander may not fail, so
+   anything we can't usefully open-code calls memcmp.  */
+void
+palmos_expand_cmpstr (operands)
+     rtx *operands;
+{
+  rtx result = gen_reg_rtx (SImode);
+
+  if (GET_CODE (operands[3]) == CONST_INT && INTVAL (operands[3]) == 0)
+    emit_move_insn (result, const0_rtx);
+  else if (GET_CODE (operands[3]) == CONST_INT
+	   && INTVAL (operands[3]) <= PALMOS_CMPMEM_INLINE_MAX)
+    {
+      rtx s1 = copy_to_mode_reg (Pmode, XEXP (operands[1], 0));
+      rtx s2 = copy_to_mode_reg (Pmode, XEXP (operands[2], 0));
+
+      emit_insn (gen_palmos_cmpstr (result, s1, s2, operands[3]));
+    }
+  else
+    {
+      enum machine_mode mode = TYPE_MODE (integer_type_node);
+      rtx value = emit_library_call_value (memcmp_libfunc, NULL_RTX, 0,
+					   mode, 3,
+					   XEXP (operands[1], 0), Pmode,
+					   XEXP (operands[2], 0), Pmode,
+					   convert_to_mode (TYPE_MODE (sizetype),
+							    operands[3], 1),
+					   TYPE_MODE (sizetype));
+      convert_move (result, value, 0);
+    }
+
+  emit_move_insn (operands[0], result);
+}
 
 /* Output a MacsBug debugger symbol.  When SIZE is 0 and NAME is eight or
    sixteen chars, we could save a few bytes by using the old fixed-length
@@ -537,6 +1471,11 @@ output_function_prologue (stream, size)
   int fsize = (size + 3) & -4;
   int cfa_offset = INCOMING_FRAME_SP_OFFSET, cfa_store_offset = cfa_offset;
 
+#ifdef PALMOS
+  if (output_millicode_prologue (stream, fsize))
+    return;
+#endif
+
 #if 0
   printf ("@@@ dump(%s) (in section `%s'):\n",
 	  current_function_name, (DECL_SECTION_NAME(current_function_decl))? 
@@ -1044,6 +1983,10 @@ output_function_epilogue (stream, size)
 
 #ifdef FUNCTION_EXTRA_EPILOGUE
   FUNCTION_EXTRA_EPILOGUE (stream, size);
+#endif
+#ifdef PALMOS
+  if (output_millicode_epilogue (stream, fsize))
+    return;
 #endif
   nregs = 0;  fmask = 0; fpoffset = 0;
 #ifdef SUPPORT_SUN_FPA
@@ -1703,6 +2646,280 @@ output_scc_di(op, operand1, operand2, dest)
   return "";
 }
 
+/* Return X if it is a nonzero constant which fits in sixteen bits
+   (unsigned, or as a magnitude when !UNSIGNEDP), or the low word of X
+   if X is a pseudo the current basic block has just set by extending a
+   HImode or QImode value.  Otherwise return 0.  The *divmodsi4
+   expanders use this to open-code a 32/16 division on the 68000 when the
+   divisor is known to be small, instead of calling __divsi3 et al.  */
+rtx
+m68k_hi_divisor (x, unsignedp)
+     rtx x;
+     int unsignedp;
+{
+  rtx insn, set, src, dest;
+
+  if (GET_CODE (x) == CONST_INT)
+    {
+      HOST_WIDE_INT d = INTVAL (x);
+
+      if (unsignedp)
+	return (d > 0 && d <= 0xffff)? x : NULL_RTX;
+      return (d != 0 && d >= -0xffff && d <= 0xffff)? x : NULL_RTX;
+    }
+
+  if (GET_CODE (x) != REG || REGNO (x) < FIRST_PSEUDO_REGISTER)
+    return NULL_RTX;
+
+  /* Find the last insn that sets X.  Stopping at a label means that
+     every path to here passes through that set.  We are called from a
+     define_expand, which has started a sequence of its own, so look in
+     the enclosing one.  */
+  insn = sequence_stack? sequence_stack->last : get_last_insn ();
+  for (; insn && GET_CODE (insn) != CODE_LABEL;
+       insn = PREV_INSN (insn))
+    if (GET_RTX_CLASS (GET_CODE (insn)) == 'i' && reg_set_p (x, insn))
+      break;
+
+  if (insn == 0 || GET_CODE (insn) == CODE_LABEL
+      || (set = single_set (insn)) == 0)
+    return NULL_RTX;
+
+  src = SET_SRC (set);
+  dest = SET_DEST (set);
+  if (dest == x
+      && GET_CODE (src) == (unsignedp? ZERO_EXTEND : SIGN_EXTEND)
+      && (GET_MODE (XEXP (src, 0)) == HImode
+	  || GET_MODE (XEXP (src, 0)) == QImode))
+    return gen_lowpart (HImode, x);
+
+  /* zero_extendhisi2 clears the register and then sets its low part.  */
+  if (unsignedp
+      && GET_CODE (dest) == STRICT_LOW_PART
+      && GET_CODE (XEXP (dest, 0)) == SUBREG
+      && SUBREG_REG (XEXP (dest, 0)) == x
+      && (GET_MODE (XEXP (dest, 0)) == HImode
+	  || GET_MODE (XEXP (dest, 0)) == QImode)
+      && (insn = prev_nonnote_insn (insn)) != 0
+      && GET_CODE (insn) == INSN
+      && (set = single_set (insn)) != 0
+      && SET_DEST (set) == x
+      && SET_SRC (set) == const0_rtx)
+    return gen_lowpart (HImode, x);
+
+  return NULL_RTX;
+}
+
+/* Output a 32/16 division, computing the 32-bit quotient in operand 0
+   and the remainder in operand 3 from the dividend in operand 1.
+   Operand 2 is the divisor: a constant that m68k_hi_divisor accepted,
+   or a HImode data register holding a value zero- or sign-extended
+   according to UNSIGNEDP.  A signed division by a register uses operand
+   4 as a scratch for the divisor's magnitude.
+
+   divu.w only gives a 16-bit quotient, so we divide the high word first
+   and then the remainder and the low word, as __udivsi3 does for small
+   divisors.  Signed divisions work on magnitudes and fix the signs up
+   afterwards.  */
+char *
+output_divmodsi_hi (insn, operands, unsignedp)
+     rtx insn;
+     rtx *operands;
+     int unsignedp;
+{
+  rtx xoperands[6];
+  int want_quotient = ! find_reg_note (insn, REG_UNUSED, operands[0]);
+  int want_remainder = ! find_reg_note (insn, REG_UNUSED, operands[3]);
+
+  /* This does not produce a usefull cc.  */
+  CC_STATUS_INIT;
+
+  xoperands[0] = operands[0];
+  xoperands[1] = operands[1];
+  xoperands[2] = operands[2];
+  xoperands[3] = operands[3];
+  xoperands[4] = operands[4];
+
+  output_asm_insn ("move%.l %1,%0", xoperands);
+  if (! unsignedp)
+    {
+      xoperands[5] = gen_label_rtx ();
+#ifdef MOTOROLA
+      output_asm_insn ("jbpl %l5\n\tneg%.l %0", xoperands);
+#else
+      output_asm_insn ("jpl %l5\n\tneg%.l %0", xoperands);
+#endif
+      ASM_OUTPUT_INTERNAL_LABEL (asm_out_file, "L",
+				 CODE_LABEL_NUMBER (xoperands[5]));
+
+      if (GET_CODE (operands[2]) == CONST_INT)
+	xoperands[2] = GEN_INT (abs (INTVAL (operands[2])));
+      else
+	{
+	  xoperands[5] = gen_label_rtx ();
+#ifdef MOTOROLA
+	  output_asm_insn ("move%.w %2,%4\n\tjbpl %l5\n\tneg%.w %4",
+			   xoperands);
+#else
+	  output_asm_insn ("move%.w %2,%4\n\tjpl %l5\n\tneg%.w %4",
+			   xoperands);
+#endif
+	  ASM_OUTPUT_INTERNAL_LABEL (asm_out_file, "L",
+				     CODE_LABEL_NUMBER (xoperands[5]));
+	  xoperands[2] = operands[4];
+	}
+    }
+
+  /* %3 = remainder:quotient of the high word, then of the remainder
+     and the low word.  */
+  output_asm_insn ("move%.l %0,%3\n\tclr%.w %3\n\tswap %3\n\tdivu%.w %2,%3",
+		   xoperands);
+  output_asm_insn ("swap %0\n\tmove%.w %3,%0\n\tswap %0\n\tmove%.w %0,%3",
+		   xoperands);
+  output_asm_insn ("divu%.w %2,%3\n\tmove%.w %3,%0", xoperands);
+
+  if (want_remainder)
+    {
+      output_asm_insn ("clr%.w %3\n\tswap %3", xoperands);
+      if (! unsignedp)
+	{
+	  /* The remainder has the sign of the dividend.  */
+	  xoperands[5] = gen_label_rtx ();
+#ifdef MOTOROLA
+	  output_asm_insn ("tst%.l %1\n\tjbpl %l5\n\tneg%.l %3", xoperands);
+#else
+	  output_asm_insn ("tst%.l %1\n\tjpl %l5\n\tneg%.l %3", xoperands);
+#endif
+	  ASM_OUTPUT_INTERNAL_LABEL (asm_out_file, "L",
+				     CODE_LABEL_NUMBER (xoperands[5]));
+	}
+    }
+
+  if (want_quotient && ! unsignedp)
+    {
+      /* The quotient is negative if exactly one operand was.  */
+      xoperands[2] = operands[2];
+      xoperands[5] = gen_label_rtx ();
+      if (GET_CODE (operands[2]) != CONST_INT)
+	output_asm_insn ("move%.w %2,%4\n\tswap %4\n\teor%.l %1,%4",
+			 xoperands);
+      else
+	output_asm_insn ("tst%.l %1", xoperands);
+#ifdef MOTOROLA
+      if (GET_CODE (operands[2]) == CONST_INT && INTVAL (operands[2]) < 0)
+	output_asm_insn ("jbmi %l5\n\tneg%.l %0", xoperands);
+      else
+	output_asm_insn ("jbpl %l5\n\tneg%.l %0", xoperands);
+#else
+      if (GET_CODE (operands[2]) == CONST_INT && INTVAL (operands[2]) < 0)
+	output_asm_insn ("jmi %l5\n\tneg%.l %0", xoperands);
+      else
+	output_asm_insn ("jpl %l5\n\tneg%.l %0", xoperands);
+#endif
+      ASM_OUTPUT_INTERNAL_LABEL (asm_out_file, "L",
+				 CODE_LABEL_NUMBER (xoperands[5]));
+    }
+
+  return "";
+}
+
+/* Output the open-coded block move or set.  For a move (SETP == 0),
+   OPERANDS are the destination and source address registers, the length
+   and the alignment; for a set they are the destination, the length, the
+   alignment, the fill byte and a data register to hold it.  The address
+   registers are stepped through the block, and without word alignment
+   everything goes a byte at a time.  Unrolled moves beat movem here: on a
+   68000 they cost no more per longword, and they need no more registers.  */
+char *
+output_palmos_block_op (operands, setp)
+     rtx *operands;
+     int setp;
+{
+  rtx xoperands[2];
+  int length, align;
+
+  CC_STATUS_INIT;
+
+  length = INTVAL (operands[setp ? 1 : 2]);
+  align = INTVAL (operands[setp ? 2 : 3]);
+
+  if (setp)
+    {
+      int byte = INTVAL (operands[3]) & 0xff;
+
+      xoperands[0] = operands[4];
+      if (byte == 0 || byte == 0xff || align < 2 || length < 2)
+	{
+	  /* Either moveq gets all the bytes right, or only one matters.  */
+	  xoperands[1] = GEN_INT (byte >= 0x80 ? byte - 0x100 : byte);
+	  output_asm_insn ("moveq %1,%0", xoperands);
+	}
+      else
+	{
+	  xoperands[1] = GEN_INT ((int) (byte * 0x01010101U));
+	  output_asm_insn ("move%.l %1,%0", xoperands);
+	}
+    }
+
+  while (length > 0)
+    {
+      enum machine_mode mode = (align < 2 || length == 1) ? QImode
+			       : (length < 4) ? HImode : SImode;
+
+      xoperands[0] = gen_rtx_MEM (mode,
+				  gen_rtx_POST_INC (Pmode, operands[0]));
+      if (setp)
+	xoperands[1] = gen_rtx_REG (mode, REGNO (operands[4]));
+      else
+	xoperands[1] = gen_rtx_MEM (mode,
+				    gen_rtx_POST_INC (Pmode, operands[1]));
+
+      if (mode == SImode)
+	output_asm_insn ("move%.l %1,%0", xoperands);
+      else if (mode == HImode)
+	output_asm_insn ("move%.w %1,%0", xoperands);
+      else
+	output_asm_insn ("move%.b %1,%0", xoperands);
+
+      length -= GET_MODE_SIZE (mode);
+    }
+
+  return "";
+}
+
+/* Output the open-coded compare of %3 bytes at %1 and %2 into %0, with
+   %4 as the loop counter.  The result is the difference between the
+   first pair of bytes which differ, as for memcmp; when the loop runs out
+   the last pair compared are equal, so the same subtraction gives zero.  */
+char *
+output_palmos_cmpstr (operands)
+     rtx *operands;
+{
+  rtx xoperands[6];
+
+  CC_STATUS_INIT;
+
+  xoperands[0] = operands[0];
+  xoperands[1] = gen_rtx_MEM (QImode, gen_rtx_POST_INC (Pmode, operands[1]));
+  xoperands[2] = gen_rtx_MEM (QImode, gen_rtx_POST_INC (Pmode, operands[2]));
+  xoperands[3] = GEN_INT (INTVAL (operands[3]) - 1);
+  xoperands[4] = operands[4];
+  xoperands[5] = gen_label_rtx ();
+
+  output_asm_insn ("moveq %3,%4", xoperands);
+  ASM_OUTPUT_INTERNAL_LABEL (asm_out_file, "L",
+			     CODE_LABEL_NUMBER (xoperands[5]));
+  output_asm_insn ("cmpm%.b %2,%1\n\tdbne %4,%l5", xoperands);
+
+  xoperands[1] = gen_rtx_MEM (QImode, plus_constant (operands[1], -1));
+  xoperands[2] = gen_rtx_MEM (QImode, plus_constant (operands[2], -1));
+  output_asm_insn ("moveq %#0,%0\n\tmove%.b %1,%0", xoperands);
+  output_asm_insn ("moveq %#0,%4\n\tmove%.b %2,%4\n\tsub%.l %4,%0",
+		   xoperands);
+
+  return "";
+}
+
 char *
 output_btst (operands, countop, dataop, insn, signpos)
      rtx *operands;
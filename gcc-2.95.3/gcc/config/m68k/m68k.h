@@ -1590,6 +1590,12 @@ __transfer_from_trampoline ()					\
    in one reasonably fast instruction.  */
 #define MOVE_MAX 4
 
+/* The block move, clear and compare patterns in m68k.md are only enabled
+   by subtargets which define TARGET_PALMOS_BUILTINS.  Everyone else gets
+   the MOVE_RATIO they would have had without them.  */
+#define TARGET_PALMOS_BUILTINS 0
+#define MOVE_RATIO (optimize_size ? 3 : 15)
+
 /* Define this if zero-extension is slow (more than one real instruction).  */
 #define SLOW_ZERO_EXTEND
 
@@ -1648,6 +1654,11 @@ __transfer_from_trampoline ()					\
 #define DIVW_COST (TARGET_68020 ? 27 : 12)
 
 #define RTX_COSTS(X,CODE,OUTER_CODE)				\
+  M68K_RTX_COSTS (X, CODE, OUTER_CODE)
+
+/* The generic m68k costs, kept separate so that subtargets which
+   redefine RTX_COSTS can fall back on them.  */
+#define M68K_RTX_COSTS(X,CODE,OUTER_CODE)			\
   case PLUS:							\
     /* An lea costs about three times as much as a simple add.  */  \
     if (GET_MODE (X) == SImode					\
@@ -2100,6 +2111,9 @@ extern char *output_move_const_single ();
 extern char *output_move_const_double ();
 extern char *output_btst ();
 extern char *output_scc_di ();
+extern char *output_divmodsi_hi ();
+extern char *output_palmos_block_op ();
+extern char *output_palmos_cmpstr ();
 extern char *output_addsi3 ();
 extern char *output_andsi3 ();
 extern char *output_iorsi3 ();
@@ -2113,6 +2127,7 @@ extern int valid_dbcc_comparison_p ();
 extern int extend_operator ();
 extern int flags_in_68881 ();
 extern int strict_low_part_peephole_ok ();
+extern struct rtx_def *m68k_hi_divisor ();
 
 /* Variables in m68k.c */
 extern const char *m68k_align_loops_string;
@@ -107,6 +107,16 @@ extern int palmos_pic_reg;
 #define MASK_RET_PTRS_A0	131072
 #define TARGET_RET_PTRS_A0	(target_flags & MASK_RET_PTRS_A0)
 
+#define MASK_DIRECT_TRAPS	262144
+#define TARGET_DIRECT_TRAPS	(target_flags & MASK_DIRECT_TRAPS)
+
+#define MASK_PALMOS_BUILTINS	524288
+#undef  TARGET_PALMOS_BUILTINS
+#define TARGET_PALMOS_BUILTINS	(target_flags & MASK_PALMOS_BUILTINS)
+
+#define MASK_MILLICODE		1048576
+#define TARGET_MILLICODE	(target_flags & MASK_MILLICODE)
+
 #undef SUBTARGET_SWITCHES
 #define SUBTARGET_SWITCHES			\
    { "debug-labels", MASK_DEBUG_LABELS },	\
@@ -118,7 +128,23 @@ extern int palmos_pic_reg;
    { "extralogues", MASK_EXTRALOGUES },		\
    { "no-extralogues", -MASK_EXTRALOGUES },	\
    { "experimental-return-reg-d0", -MASK_RET_PTRS_A0 }, \
-   { "no-experimental-return-reg-d0", MASK_RET_PTRS_A0 },
+   { "no-experimental-return-reg-d0", MASK_RET_PTRS_A0 }, \
+   { "direct-traps", MASK_DIRECT_TRAPS },	\
+   { "no-direct-traps", -MASK_DIRECT_TRAPS },	\
+   { "palmos-builtins", MASK_PALMOS_BUILTINS },	\
+   { "no-palmos-builtins", -MASK_PALMOS_BUILTINS },	\
+   { "millicode", MASK_MILLICODE },		\
+   { "no-millicode", -MASK_MILLICODE },
+
+/* -mtune=dragonball and -mtune=dragonball-vz select a cost model for the
+   DragonBall cores in Palm OS devices; see palmos_select_tune.  */
+extern const char *palmos_tune_string;
+extern int palmos_tune_dragonball;
+#define TARGET_TUNE_DRAGONBALL	(palmos_tune_dragonball)
+
+#undef SUBTARGET_OPTIONS
+#define SUBTARGET_OPTIONS			\
+  { "tune=",	&palmos_tune_string },
 
 /* Target defaults are -mpcrel -mshort -m68000 -msoft-float.  */
 #undef TARGET_DEFAULT
@@ -132,7 +158,43 @@ extern int palmos_pic_reg;
     if (TARGET_OWN_GP)							\
       target_flags |= MASK_EXTRALOGUES;					\
     palmos_pic_reg = (TARGET_OWN_GP)? 12 : 13;			\
+    palmos_select_tune ();						\
   }
+extern void palmos_select_tune ();
+
+/* With -mtune=dragonball*, use DragonBall timings for everything that has
+   an interesting cost; otherwise use the generic m68k costs.  */
+extern int palmos_rtx_costs ();
+#undef RTX_COSTS
+#define RTX_COSTS(X,CODE,OUTER_CODE)					\
+  case PLUS: case MINUS: case AND: case IOR: case XOR:			\
+  case NEG: case NOT: case SIGN_EXTEND: case ZERO_EXTEND:		\
+  case ASHIFT: case ASHIFTRT: case LSHIFTRT: case ROTATE: case ROTATERT:\
+  case MULT: case DIV: case UDIV: case MOD: case UMOD: case MEM:	\
+    if (TARGET_TUNE_DRAGONBALL)						\
+      return palmos_rtx_costs (X, CODE, OUTER_CODE);			\
+    switch (CODE)							\
+      {									\
+      M68K_RTX_COSTS (X, CODE, OUTER_CODE)				\
+      default:								\
+	break;								\
+      }									\
+    break;
+
+extern int palmos_address_cost ();
+#define ADDRESS_COST(X)							\
+  (TARGET_TUNE_DRAGONBALL ? palmos_address_cost (X) : rtx_cost ((X), MEM))
+
+/* With -mpalmos-builtins, the movstrsi and clrstrsi expanders decide how
+   to handle every block longer than a single move; see palmos_expand_movstr.
+   The builtin memset with a non-zero value goes to palmos_expand_memset.  */
+#undef  MOVE_RATIO
+#define MOVE_RATIO (TARGET_PALMOS_BUILTINS ? 2 : optimize_size ? 3 : 15)
+
+extern int palmos_expand_movstr ();
+extern int palmos_expand_setstr ();
+extern void palmos_expand_cmpstr ();
+extern struct rtx_def *palmos_expand_memset ();
 
 /* Always disallow function-cse for calls to callseq functions.  */
 #define FORBID_FUNCTION_CSE_P(EXP)					\
@@ -207,7 +269,7 @@ define CONSTANT_AFTER_FUNCTION_P(EXP) 1
 
 #undef LINK_SPEC
 #define LINK_SPEC \
-  "--embedded-relocs --no-check-sections -N %{!static:-dy}"
+  "--emit-relocs --no-check-sections -N %{!static:-dy}"
 
 #undef STARTFILE_SPEC
 #define STARTFILE_SPEC \
@@ -222,7 +284,7 @@ define CONSTANT_AFTER_FUNCTION_P(EXP) 1
 #undef CPP_SUBTARGET_SPEC
 #define CPP_SUBTARGET_SPEC \
   "%{mown-gp:-D__OWNGP__} %{mextralogues:-D__EXTRALOGUES__} \
-   %{!mnoshort:-D__INT_MAX__=32767}"
+   %{mdirect-traps:-D__DIRECT_TRAPS__} %{!mnoshort:-D__INT_MAX__=32767}"
 
 #undef SUBTARGET_EXTRA_SPECS
 #define SUBTARGET_EXTRA_SPECS \
@@ -238,10 +300,64 @@ define CONSTANT_AFTER_FUNCTION_P(EXP) 1
        %{pedantic*} %{H} %C %{D*} %{U*} %{i*} %Z %i" }, \
   { "cpp_debug_options", "%{d*}" },
 
+/* Emit the table entries for any systraps called via -mdirect-traps, and
+   local copies of any -mmillicode routines used in named sections.  */
+extern void palmos_asm_file_end ();
+#define ASM_FILE_END(FILE)  palmos_asm_file_end (FILE)
+
 extern int palmos_valid_machine_decl_attribute ();
 #define VALID_MACHINE_DECL_ATTRIBUTE(DECL, ATTRIBUTES, ID, ARGS)	\
   palmos_valid_machine_decl_attribute (DECL, ATTRIBUTES, ID, ARGS)
 
+/* Functions whose type has a regparm (N) attribute take their first N
+   integer and pointer arguments in registers; see palmos_function_arg.  */
+#define PALMOS_REGPARM_MAX  5
+
+extern int palmos_valid_machine_type_attribute ();
+#define VALID_MACHINE_TYPE_ATTRIBUTE(TYPE, ATTRIBUTES, ID, ARGS)	\
+  palmos_valid_machine_type_attribute (TYPE, ATTRIBUTES, ID, ARGS)
+
+extern int palmos_comp_type_attributes ();
+#define COMP_TYPE_ATTRIBUTES(TYPE1, TYPE2)				\
+  palmos_comp_type_attributes (TYPE1, TYPE2)
+
+extern int palmos_regparm ();
+
+struct palmos_cumulative_args
+{
+  int nregs;	/* Number of arguments still to be passed in registers.  */
+  int dregs;	/* Number of data registers used so far.  */
+  int aregs;	/* Number of address registers used so far.  */
+};
+
+#undef CUMULATIVE_ARGS
+#define CUMULATIVE_ARGS struct palmos_cumulative_args
+
+extern void palmos_init_cumulative_args ();
+#undef INIT_CUMULATIVE_ARGS
+#define INIT_CUMULATIVE_ARGS(CUM, FNTYPE, LIBNAME, INDIRECT)		\
+  palmos_init_cumulative_args (&(CUM), FNTYPE)
+
+extern void palmos_init_incoming_args ();
+#define INIT_CUMULATIVE_INCOMING_ARGS(CUM, FNTYPE, LIBNAME)		\
+  palmos_init_incoming_args (&(CUM), FNTYPE)
+
+extern void palmos_function_arg_advance ();
+#undef FUNCTION_ARG_ADVANCE
+#define FUNCTION_ARG_ADVANCE(CUM, MODE, TYPE, NAMED)			\
+  palmos_function_arg_advance (&(CUM), MODE, TYPE, NAMED)
+
+extern struct rtx_def *palmos_function_arg ();
+#undef FUNCTION_ARG
+#define FUNCTION_ARG(CUM, MODE, TYPE, NAMED)				\
+  palmos_function_arg (&(CUM), MODE, TYPE, NAMED)
+
+#undef FUNCTION_ARG_PARTIAL_NREGS
+#define FUNCTION_ARG_PARTIAL_NREGS(CUM, MODE, TYPE, NAMED)  0
+
+#undef FUNCTION_ARG_REGNO_P
+#define FUNCTION_ARG_REGNO_P(N)  ((N) <= 2 || (N) == 8 || (N) == 9)
+
 #if 0
 extern union tree_node *palmos_wibble();
 #define MERGE_MACHINE_DECL_ATTRIBUTES(OLDDECL, NEWDECL)			\
@@ -267,6 +383,14 @@ curfunc_section ()							\
 
 #define RECALL_CONSTANT_NAME_SECTION_INFO
 
+/* Palm OS applications are linked statically, so no symbol can be
+   preempted, and the difference of any two addresses (such as a
+   -fvtable-relative vtable entry) is fixed at link time.  */
+#define BINDS_LOCAL_P(DECL)  1
+
+/* A variable in the text section is addressed pc-relative.  That's known
+   once it has been output, or beforehand if the front end has set
+   DECL_IN_TEXT_SECTION, as C++ does for -fvtable-relative vtables.  */
 extern void palmos_encode_section_info ();
 #define ENCODE_SECTION_INFO(decl)					\
 do									\
@@ -278,15 +402,13 @@ do									\
 	&& GET_CODE (sym) == MEM					\
 	&& GET_CODE (XEXP (sym, 0)) == SYMBOL_REF)			\
       {									\
-	if (decl_code == VAR_DECL && TREE_ASM_WRITTEN (decl))		\
+	if (decl_code == VAR_DECL)					\
 	  SYMBOL_REF_FLAG (XEXP (sym, 0)) = DECL_IN_TEXT_SECTION (decl);\
-	else if (decl_code == FUNCTION_DECL)				\
+	else								\
 	  {								\
 	    SYMBOL_REF_FLAG (XEXP (sym, 0)) = 1;			\
 	    palmos_encode_section_info (sym, decl, 0);			\
 	  }								\
-	else								\
-	  SYMBOL_REF_FLAG (XEXP (sym, 0)) = 0;				\
       }									\
     else if ((decl_code == REAL_CST || decl_code == STRING_CST		\
 	      || decl_code == COMPLEX_CST || decl_code == CONSTRUCTOR)	\
@@ -852,12 +852,16 @@ standard_conversion (to, from, expr)
 	  || ! same_type_p (TREE_TYPE (fromfn), TREE_TYPE (tofn))
 	  || ! compparms (TREE_CHAIN (TYPE_ARG_TYPES (fromfn)),
 			  TREE_CHAIN (TYPE_ARG_TYPES (tofn)))
+#ifdef COMP_TYPE_ATTRIBUTES
+	  || ! COMP_TYPE_ATTRIBUTES (fromfn, tofn)
+#endif
 	  || CP_TYPE_QUALS (fbase) != CP_TYPE_QUALS (tbase))
 	return 0;
 
       from = cp_build_qualified_type (tbase, CP_TYPE_QUALS (fbase));
       from = build_cplus_method_type (from, TREE_TYPE (fromfn),
 				      TREE_CHAIN (TYPE_ARG_TYPES (fromfn)));
+      from = build_type_attribute_variant (from, TYPE_ATTRIBUTES (fromfn));
       from = build_ptrmemfunc_type (build_pointer_type (from));
       conv = build_conv (PMEM_CONV, from, conv);
     }
@@ -570,6 +570,30 @@ build_vtbl_ref (instance, idx)
   return aref;
 }
 
+/* Return the address of the function in the (non-thunk) vtable entry
+   ENTRY.  With -fvtable-relative, the pfn field holds the offset of the
+   function from the field itself, so the address is found by adding the
+   two.  */
+
+tree
+build_vtable_entry_pfn (entry)
+     tree entry;
+{
+  tree pfn = build_component_ref (entry, pfn_identifier, NULL_TREE, 0);
+
+  if (flag_vtable_relative)
+    {
+      tree addr = save_expr (build_unary_op (ADDR_EXPR, pfn, 0));
+      pfn = build (PLUS_EXPR, ptrdiff_type_node,
+		   cp_convert (ptrdiff_type_node, addr),
+		   cp_convert (ptrdiff_type_node,
+			       build_indirect_ref (addr, NULL_PTR)));
+      pfn = cp_convert (ptr_type_node, pfn);
+    }
+
+  return pfn;
+}
+
 /* Given an object INSTANCE, return an expression which yields the
    virtual function corresponding to INDEX.  There are many special
    cases for INSTANCE which we take care of here, mainly to avoid
@@ -601,7 +625,7 @@ build_vfn_ref (ptr_to_instptr, instance, idx)
 			     build_component_ref (aref, delta_identifier, NULL_TREE, 0)));
     }
 
-  return build_component_ref (aref, pfn_identifier, NULL_TREE, 0);
+  return build_vtable_entry_pfn (aref);
 }
 
 /* Return the name of the virtual function table (as an IDENTIFIER_NODE)
@@ -751,6 +775,10 @@ build_vtable (binfo, type)
   /* Make them READONLY by default. (mrs) */
   TREE_READONLY (decl) = 1;
 #endif
+  /* Self-relative vtables need no relocation, so they go in the read-only
+     section, which is the text section on the targets that want them.
+     Say so now, before any references to the vtable are generated.  */
+  DECL_IN_TEXT_SECTION (decl) = flag_vtable_relative;
   /* At one time the vtable info was grabbed 2 words at a time.  This
      fails on sparc unless you have 8-byte alignment.  (tiemann) */
   DECL_ALIGN (decl) = MAX (TYPE_ALIGN (double_type_node),
@@ -889,6 +917,7 @@ prepare_fresh_vtable (binfo, for_type)
   /* Make them READONLY by default. (mrs) */
   TREE_READONLY (new_decl) = 1;
 #endif
+  DECL_IN_TEXT_SECTION (new_decl) = flag_vtable_relative;
   DECL_ALIGN (new_decl) = DECL_ALIGN (orig_decl);
 
   /* Make fresh virtual list, so we can smash it later.  */
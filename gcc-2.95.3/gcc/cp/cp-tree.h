@@ -559,6 +559,9 @@ extern int flag_strict_prototype;
 /* Nonzero means output .vtable_{entry,inherit} for use in doing vtable gc.  */
 extern int flag_vtable_gc;
 
+/* Nonzero means vtable entries hold self-relative function offsets.  */
+extern int flag_vtable_relative;
+
 /* Nonzero means make the default pedwarns warnings instead of errors.
    The value of this flag is ignored if -pedantic is specified.  */
 extern int flag_permissive;
@@ -2771,6 +2774,7 @@ extern int is_properly_derived_from             PROTO((tree, tree));
 /* in class.c */
 extern tree build_vbase_path			PROTO((enum tree_code, tree, tree, tree, int));
 extern tree build_vtbl_ref			PROTO((tree, tree));
+extern tree build_vtable_entry_pfn		PROTO((tree));
 extern tree build_vfn_ref			PROTO((tree *, tree, tree));
 extern void add_method				PROTO((tree, tree *, tree));
 extern int currently_open_class			PROTO((tree));
@@ -6817,6 +6817,13 @@ init_decl_processing ()
   wchar_array_type_node
     = build_array_type (wchar_type_node, array_domain_type);
 
+  if (flag_vtable_relative && (flag_vtable_thunks || flag_handle_signatures))
+    {
+      error ("-fvtable-relative cannot be used with %s",
+	     flag_vtable_thunks ? "-fvtable-thunks" : "-fhandle-signatures");
+      flag_vtable_relative = 0;
+    }
+
   if (flag_vtable_thunks)
     {
       /* Make sure we get a unique function type, so we can give
@@ -6835,8 +6842,10 @@ init_decl_processing ()
 					 delta_type_node);
       fields[1] = build_lang_field_decl (FIELD_DECL, index_identifier,
 					 delta_type_node);
+      /* A self-relative pfn is an offset like DELTA, and the same size.  */
       fields[2] = build_lang_field_decl (FIELD_DECL, pfn_identifier,
-					 ptr_type_node);
+					 flag_vtable_relative
+					 ? delta_type_node : ptr_type_node);
       finish_builtin_type (vtable_entry_type, VTBL_PTR_TYPE, fields, 2,
 			   double_type_node);
 
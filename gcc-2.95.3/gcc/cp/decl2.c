@@ -69,6 +69,7 @@ typedef struct priority_info_s {
 
 static tree get_sentry PROTO((tree));
 static void mark_vtable_entries PROTO((tree));
+static void make_vtable_entries_relative PROTO((tree));
 static void grok_function_init PROTO((tree, tree));
 static int finish_vtable_vardecl PROTO((tree *, void *));
 static int prune_vtable_vardecl PROTO((tree *, void *));
@@ -480,6 +481,12 @@ int flag_do_squangling;
 
 int flag_vtable_gc;
 
+/* Nonzero means vtable entries hold the offset of each virtual function
+   from the entry rather than its address, so vtables need no relocation
+   and can be placed in the text section.  */
+
+int flag_vtable_relative;
+
 /* Nonzero means make the default pedwarns warnings instead of errors.
    The value of this flag is ignored if -pedantic is specified.  */
 
@@ -535,6 +542,7 @@ lang_f_options[] =
   {"strict-prototype", &flag_strict_prototype, 1},
   {"this-is-variable", &flag_this_is_variable, 1},
   {"vtable-gc", &flag_vtable_gc, 1},
+  {"vtable-relative", &flag_vtable_relative, 1},
   {"vtable-thunks", &flag_vtable_thunks, 1},
   {"weak", &flag_weak, 1},
   {"xref", &flag_gnu_xref, 1}
@@ -2520,6 +2528,60 @@ mark_vtable_entries (decl)
     }
 }
 
+/* With -fvtable-relative, replace the function address in each entry of
+   the vtable DECL by the offset of the function from the entry's pfn
+   field.  That difference is fixed at link time, so the vtable needs no
+   relocation as long as it is in the same section as the functions.  */
+
+static void
+make_vtable_entries_relative (decl)
+     tree decl;
+{
+  tree pfn_field = TREE_CHAIN (TREE_CHAIN (TYPE_FIELDS (vtable_entry_type)));
+  HOST_WIDE_INT size = int_size_in_bytes (vtable_entry_type);
+  HOST_WIDE_INT offset
+    = TREE_INT_CST_LOW (DECL_FIELD_BITPOS (pfn_field)) / BITS_PER_UNIT;
+  tree base = build1 (ADDR_EXPR, ptr_type_node, decl);
+  tree entries = NULL_TREE;
+  tree elts, init;
+
+  TREE_CONSTANT (base) = 1;
+
+  for (elts = CONSTRUCTOR_ELTS (DECL_INITIAL (decl)); elts;
+       elts = TREE_CHAIN (elts), offset += size)
+    {
+      tree entry = TREE_VALUE (elts);
+      tree fnaddr = FNADDR_FROM_VTABLE_ENTRY (entry);
+      tree pfn, here;
+
+      if (TREE_CODE (fnaddr) == NOP_EXPR)
+	/* RTTI offset.  */
+	pfn = cp_convert (delta_type_node, TREE_OPERAND (fnaddr, 0));
+      else
+	{
+	  tree fn = TREE_OPERAND (fnaddr, 0);
+	  if (TREE_CODE (fn) == FUNCTION_DECL && DECL_SECTION_NAME (fn))
+	    cp_error ("`%D' is in section `%s', but -fvtable-relative vtables can only refer to the text section",
+		      fn, TREE_STRING_POINTER (DECL_SECTION_NAME (fn)));
+
+	  here = build (PLUS_EXPR, ptr_type_node, base, size_int (offset));
+	  TREE_CONSTANT (here) = 1;
+	  pfn = build (MINUS_EXPR, delta_type_node, fnaddr, here);
+	  TREE_CONSTANT (pfn) = 1;
+	}
+
+      /* The entries are shared with other vtables, so make new ones.  */
+      entry = copy_node (entry);
+      CONSTRUCTOR_ELTS (entry) = copy_list (CONSTRUCTOR_ELTS (entry));
+      SET_FNADDR_FROM_VTABLE_ENTRY (entry, pfn);
+      entries = expr_tree_cons (TREE_PURPOSE (elts), entry, entries);
+    }
+
+  init = copy_node (DECL_INITIAL (decl));
+  CONSTRUCTOR_ELTS (init) = nreverse (entries);
+  DECL_INITIAL (decl) = init;
+}
+
 /* Set DECL up to have the closest approximation of "initialized common"
    linkage available.  */
 
@@ -2762,6 +2824,8 @@ finish_vtable_vardecl (t, data)
       /* JWM  printf ("; banana 1\n"); */
       /* JWM  output_asm_insn ("; banana 1", NULL); */
       mark_vtable_entries (vars);
+      if (flag_vtable_relative)
+	make_vtable_entries_relative (vars);
       /* JWM  output_asm_insn ("; banana 2", NULL); */
       if (TREE_TYPE (DECL_INITIAL (vars)) == 0)
 	store_init_value (vars, DECL_INITIAL (vars));
@@ -99,6 +99,8 @@ DEFINE_LANG_NAME ("C++")
   { "-fno-this-is-variable", "" },
   { "-fvtable-gc", "Discard unused virtual functions" },
   { "-fno-vtable-gc", "" },
+  { "-fvtable-relative", "Make vtable entries self-relative offsets" },
+  { "-fno-vtable-relative", "" },
   { "-fvtable-thunks", "Implement vtables using thunks" },
   { "-fno-vtable-thunks", "" },
   { "-fweak", "Emit common-like symbols as weak symbols" },
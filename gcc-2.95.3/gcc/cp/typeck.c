@@ -1084,6 +1084,9 @@ comp_target_types (ttl, ttr, nptrs)
       tree argsl, argsr;
       int saw_contra = 0;
 
+      if (! COMP_TYPE_ATTRIBUTES (ttl, ttr))
+	return 0;
+
       if (pedantic)
 	{
 	  if (!same_type_p (TREE_TYPE (ttl), TREE_TYPE (ttr)))
@@ -2888,7 +2891,13 @@ get_member_function_from_ptrfunc (instance_ptrptr, function)
 							 integer_one_node));
 	  if (! flag_vtable_thunks)
 	    {
-	      aref = save_expr (aref);
+	      /* A self-relative pfn is an offset from where the entry
+		 lives, so save the entry's address rather than a copy.  */
+	      if (flag_vtable_relative)
+		aref = build_indirect_ref
+		  (save_expr (build_unary_op (ADDR_EXPR, aref, 0)), NULL_PTR);
+	      else
+		aref = save_expr (aref);
 
 	      delta = build_binary_op
 		(PLUS_EXPR,
@@ -2903,7 +2912,7 @@ get_member_function_from_ptrfunc (instance_ptrptr, function)
 	  if (flag_vtable_thunks)
 	    e2 = aref;
 	  else
-	    e2 = build_component_ref (aref, pfn_identifier, NULL_TREE, 0);
+	    e2 = build_vtable_entry_pfn (aref);
 	  TREE_TYPE (e2) = TREE_TYPE (e3);
 	  e1 = build_conditional_expr (e1, e2, e3);
 
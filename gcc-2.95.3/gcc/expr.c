@@ -9543,6 +9543,22 @@ expand_builtin (exp, target, subtarget, mode, ignore)
 	  if (TREE_SIDE_EFFECTS (val) || TREE_SIDE_EFFECTS (len))
 	    break;
 
+#ifdef PALMOS
+	  /* Palm OS can also fill with other values, inline or by MemSet.  */
+	  if (TARGET_PALMOS_BUILTINS)
+	    {
+	      rtx result
+		= palmos_expand_memset (get_memory_rtx (dest),
+					expand_expr (val, NULL_RTX,
+						     VOIDmode, 0),
+					expand_expr (len, NULL_RTX,
+						     VOIDmode, 0),
+					dest_align);
+	      if (result)
+		return result;
+	    }
+#endif
+
 	  /* If VAL is not 0, don't do this operation in-line. */
 	  if (expand_expr (val, NULL_RTX, VOIDmode, 0) != const0_rtx)
 	    break;
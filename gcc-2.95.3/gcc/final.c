@@ -3652,15 +3652,20 @@ output_addr_const (file, x)
 
       output_addr_const (file, XEXP (x, 0));
       fprintf (file, "-");
-      if (GET_CODE (XEXP (x, 1)) == CONST_INT
-	  && INTVAL (XEXP (x, 1)) < 0)
+      if ((GET_CODE (XEXP (x, 1)) == CONST_INT
+	   && INTVAL (XEXP (x, 1)) >= 0)
+	  || GET_CODE (XEXP (x, 1)) == PC
+	  || GET_CODE (XEXP (x, 1)) == SYMBOL_REF
+	  || GET_CODE (XEXP (x, 1)) == LABEL_REF
+	  || GET_CODE (XEXP (x, 1)) == CODE_LABEL)
+	output_addr_const (file, XEXP (x, 1));
+      else
 	{
+	  /* Parenthesize negative constants and sums such as `sym+4'.  */
 	  fprintf (file, ASM_OPEN_PAREN);
 	  output_addr_const (file, XEXP (x, 1));
 	  fprintf (file, ASM_CLOSE_PAREN);
 	}
-      else
-	output_addr_const (file, XEXP (x, 1));
       break;
 
     case ZERO_EXTEND:
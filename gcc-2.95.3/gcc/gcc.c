@@ -64,6 +64,13 @@ compilation is specified by a string called a "spec".  */
 #define OBJECT_SUFFIX ".o"
 #endif
 
+/* Compiling several input files at once (-j) needs fork, so hosts where
+   pexecute can't use it compile them one at a time regardless.  */
+#if ! defined (__MSDOS__) && ! defined (OS2) && ! defined (VMS) \
+    && ! (defined (_WIN32) && ! defined (__CYGWIN__))
+#define HAVE_PARALLEL_COMPILES
+#endif
+
 /* By default, colon separates directories in a path.  */
 #ifndef PATH_SEPARATOR
 #define PATH_SEPARATOR ':'
@@ -137,6 +144,10 @@ static int verbose_flag;
 
 static int save_temps_flag;
 
+/* The maximum number of input files to compile at once (-j).  */
+
+static int n_jobs = 1;
+
 /* The compiler version.  */
 
 static char *compiler_version;
@@ -224,6 +235,10 @@ static int execute			PROTO ((void));
 static void unused_prefix_warnings	PROTO ((struct path_prefix *));
 static void clear_args			PROTO ((void));
 static void fatal_error			PROTO ((int));
+static int compile_input_file		PROTO ((int, char *));
+#ifdef HAVE_PARALLEL_COMPILES
+static int compile_files_in_parallel	PROTO ((char *));
+#endif
 
 void fancy_abort		PROTO((void)) ATTRIBUTE_NORETURN;
 
@@ -523,7 +538,7 @@ static struct user_specs *user_specs_head, *user_specs_tail;
    || (CHAR) == 'e' || (CHAR) == 'T' || (CHAR) == 'u' \
    || (CHAR) == 'I' || (CHAR) == 'm' || (CHAR) == 'x' \
    || (CHAR) == 'L' || (CHAR) == 'A' || (CHAR) == 'V' \
-   || (CHAR) == 'B' || (CHAR) == 'b')
+   || (CHAR) == 'B' || (CHAR) == 'b' || (CHAR) == 'j')
 
 #ifndef SWITCH_TAKES_ARG
 #define SWITCH_TAKES_ARG(CHAR) DEFAULT_SWITCH_TAKES_ARG(CHAR)
@@ -2492,6 +2507,7 @@ display_help ()
   printf ("  -Xlinker <arg>           Pass <arg> on to the linker\n");
   printf ("  -save-temps              Do not delete intermediate files\n");
   printf ("  -pipe                    Use pipes rather than intermediate files\n");
+  printf ("  -j <number>              Compile up to <number> input files at once\n");
   printf ("  -specs=<file>            Override builtin specs with the contents of <file>\n");
   printf ("  -std=<standard>          Assume that the input sources are for <standard>\n");
   printf ("  -B <directory>           Add <directory> to the compiler's search paths\n");
@@ -2883,6 +2899,15 @@ process_command (argc, argv)
 
 	  switch (c)
 	    {
+	    case 'j':
+	      n_switches++;
+	      if (p[1] == 0 && i + 1 == argc)
+		fatal ("argument to `-j' is missing");
+	      n_jobs = atoi (p[1] == 0 ? argv[++i] : p + 1);
+	      if (n_jobs < 1)
+		fatal ("argument to `-j' must be a positive number");
+	      break;
+
 	    case 'b':
               n_switches++;
 	      if (p[1] == 0 && i + 1 == argc)
@@ -3288,7 +3313,7 @@ process_command (argc, argv)
           else
             {
               char ch = switches[n_switches].part1[0];
-              if (ch == 'V' || ch == 'b' || ch == 'B')
+              if (ch == 'V' || ch == 'b' || ch == 'B' || ch == 'j')
                 switches[n_switches].validated = 1;
             }
 	  n_switches++;
@@ -4628,6 +4653,354 @@ is_directory (path1, path2, linker)
   return (stat (path, &st) >= 0 && S_ISDIR (st.st_mode));
 }
 
+/* Compile input file I, recording it in EXPLICIT_LINK_FILES if it is
+   only linker input.  Return nonzero if the compilation failed.  */
+
+static int
+compile_input_file (i, explicit_link_files)
+     int i;
+     char *explicit_link_files;
+{
+  register struct compiler *cp = 0;
+  int this_file_error = 0;
+  int value;
+  size_t j;
+
+  /* Tell do_spec what to substitute for %i.  */
+
+  input_filename = infiles[i].name;
+  input_filename_length = strlen (input_filename);
+  input_file_number = i;
+
+  /* Use the same thing in %o, unless cp->spec says otherwise.  */
+
+  outfiles[i] = input_filename;
+
+  /* Figure out which compiler from the file's suffix.  */
+
+  cp = lookup_compiler (infiles[i].name, input_filename_length,
+			infiles[i].language);
+
+  if (cp)
+    {
+      /* Ok, we found an applicable compiler.  Run its spec.  */
+      /* First say how much of input_filename to substitute for %b  */
+      register const char *p;
+      int len;
+
+      if (cp->spec[0][0] == '#')
+	error ("%s: %s compiler not installed on this system",
+	       input_filename, &cp->spec[0][1]);
+
+      input_basename = input_filename;
+      for (p = input_filename; *p; p++)
+	if (IS_DIR_SEPARATOR (*p))
+	  input_basename = p + 1;
+
+      /* Find a suffix starting with the last period,
+	 and set basename_length to exclude that suffix.  */
+      basename_length = strlen (input_basename);
+      p = input_basename + basename_length;
+      while (p != input_basename && *p != '.') --p;
+      if (*p == '.' && p != input_basename)
+	{
+	  basename_length = p - input_basename;
+	  input_suffix = p + 1;
+	}
+      else
+	input_suffix = "";
+
+      len = 0;
+      for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
+	if (cp->spec[j])
+	  len += strlen (cp->spec[j]);
+
+      {
+	char *p1 = (char *) xmalloc (len + 1);
+
+	len = 0;
+	for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
+	  if (cp->spec[j])
+	    {
+	      strcpy (p1 + len, cp->spec[j]);
+	      len += strlen (cp->spec[j]);
+	    }
+
+	value = do_spec (p1);
+	free (p1);
+      }
+      if (value < 0)
+	this_file_error = 1;
+    }
+
+  /* If this file's name does not contain a recognized suffix,
+     record it as explicit linker input.  */
+
+  else
+    explicit_link_files[i] = 1;
+
+  /* Clear the delete-on-failure queue, deleting the files in it
+     if this compilation failed.  */
+
+  if (this_file_error)
+    delete_failure_queue ();
+  /* If this compilation succeeded, don't delete those files later.  */
+  clear_failure_queue ();
+
+  return this_file_error;
+}
+
+#ifdef HAVE_PARALLEL_COMPILES
+
+/* With -j, each input file is compiled by a child process of its own,
+   which runs exactly the commands compile_input_file would.  The child's
+   standard output and diagnostics go to temporary files, which are copied
+   out in input file order, so that the output looks just as it does when
+   the files are compiled one at a time.  The child reports the name of its
+   output file, for the link, and which -B prefixes it used through a pipe.  */
+
+struct compile_job
+{
+  int pid;			/* Child process, or 0 if none was needed.  */
+  int finished;			/* Nonzero once the child has exited.  */
+  int status;			/* Its exit status.  */
+  int result_fd;		/* Read end of the pipe from the child.  */
+  FILE *output;			/* Its standard output.  */
+  FILE *errors;			/* Its standard error.  */
+};
+
+/* In the child: compile input file I and send the parent, through
+   RESULT_FD, a flag saying whether our output file is a temporary file to
+   be deleted after the link, the -B and -b/-V prefix usage flags, and the
+   output file name.  Does not return.  */
+
+static void
+run_compile_job (i, explicit_link_files, result_fd)
+     int i;
+     char *explicit_link_files;
+     int result_fd;
+{
+  struct temp_file **tp;
+  int failed;
+  char flags[3];
+
+  /* The temporary files recorded so far belong to the parent.  */
+  always_delete_queue = 0;
+  failure_delete_queue = 0;
+
+#ifndef MKTEMP_EACH_FILE
+  /* Don't clash with the temporary files of the other children.  */
+  temp_filename = choose_temp_base ();
+  temp_filename_length = strlen (temp_filename);
+#endif
+
+  failed = compile_input_file (i, explicit_link_files) || error_count > 0;
+
+  if (! failed)
+    {
+      flags[0] = '0';
+      flags[1] = warn_B ? '1' : '0';
+      flags[2] = warn_std ? '1' : '0';
+
+      /* Leave the output file for the parent to delete.  */
+      for (tp = &always_delete_queue; *tp; tp = &(*tp)->next)
+	if (strcmp ((*tp)->name, outfiles[i]) == 0)
+	  {
+	    *tp = (*tp)->next;
+	    flags[0] = '1';
+	    break;
+	  }
+
+      if (write (result_fd, flags, sizeof flags) != sizeof flags
+	  || write (result_fd, outfiles[i], strlen (outfiles[i]) + 1) < 0)
+	failed = 1;
+    }
+
+  delete_temp_files ();
+  fflush (stdout);
+  fflush (stderr);
+  _exit (! failed ? 0 : signal_count ? 2 : 1);
+}
+
+/* Start compiling input file I as JOB.  Return nonzero if a child process
+   was started; files which are just linker input are dealt with here.  */
+
+static int
+start_compile_job (i, job, explicit_link_files)
+     int i;
+     struct compile_job *job;
+     char *explicit_link_files;
+{
+  int fd[2];
+
+  if (! lookup_compiler (infiles[i].name, strlen (infiles[i].name),
+			 infiles[i].language))
+    {
+      compile_input_file (i, explicit_link_files);
+      job->finished = 1;
+      return 0;
+    }
+
+  job->output = tmpfile ();
+  job->errors = tmpfile ();
+  if (job->output == NULL || job->errors == NULL)
+    pfatal_with_name ("tmpfile");
+  if (pipe (fd) < 0)
+    pfatal_with_name ("pipe");
+
+  fflush (stdout);
+  fflush (stderr);
+
+  job->pid = fork ();
+  if (job->pid < 0)
+    pfatal_with_name ("fork");
+
+  if (job->pid == 0)
+    {
+      close (fd[0]);
+      dup2 (fileno (job->output), 1);
+      dup2 (fileno (job->errors), 2);
+      run_compile_job (i, explicit_link_files, fd[1]);
+    }
+
+  close (fd[1]);
+  job->result_fd = fd[0];
+  return 1;
+}
+
+/* Copy the contents of the temporary file FROM to TO, and close it.  */
+
+static void
+copy_job_output (from, to)
+     FILE *from;
+     FILE *to;
+{
+  char buf[BUFSIZ];
+  size_t n;
+
+  rewind (from);
+  while ((n = fread (buf, 1, sizeof buf, from)) > 0)
+    fwrite (buf, 1, n, to);
+  fflush (to);
+  fclose (from);
+}
+
+/* Finish off input file I, whose JOB has exited: pass on its output and
+   collect its output file name.  Return nonzero if the compilation
+   failed.  */
+
+static int
+finish_compile_job (i, job)
+     int i;
+     struct compile_job *job;
+{
+  char *result = NULL;
+  int result_len = 0;
+  int failed;
+
+  if (job->pid == 0)
+    return 0;
+
+  copy_job_output (job->output, stdout);
+  copy_job_output (job->errors, stderr);
+
+  failed = job->status != 0;
+  if (WIFSIGNALED (job->status) || WEXITSTATUS (job->status) == 2)
+    signal_count++;
+
+  if (! failed)
+    {
+      char buf[256];
+      int n;
+
+      while ((n = read (job->result_fd, buf, sizeof buf)) > 0)
+	{
+	  result = xrealloc (result, result_len + n);
+	  memcpy (result + result_len, buf, n);
+	  result_len += n;
+	}
+
+      if (result_len < 4 || result[result_len - 1] != '\0')
+	{
+	  error ("%s: lost the output of this compilation", infiles[i].name);
+	  failed = 1;
+	}
+      else
+	{
+	  outfiles[i] = result + 3;
+	  if (result[0] == '1')
+	    record_temp_file (outfiles[i], 1, 0);
+	  if (result[1] == '1')
+	    warn_B = 1;
+	  if (result[2] == '1')
+	    warn_std = 1;
+	}
+    }
+
+  close (job->result_fd);
+  return failed;
+}
+
+/* Compile all the input files, up to N_JOBS at a time.  Return the number
+   of compilations which failed.  */
+
+static int
+compile_files_in_parallel (explicit_link_files)
+     char *explicit_link_files;
+{
+  struct compile_job *jobs;
+  int next_to_start = 0;
+  int next_to_finish = 0;
+  int running = 0;
+  int failures = 0;
+
+  jobs = (struct compile_job *) xmalloc (n_infiles * sizeof *jobs);
+  bzero ((char *) jobs, n_infiles * sizeof *jobs);
+
+  while (next_to_finish < n_infiles)
+    {
+      while (next_to_start < n_infiles && running < n_jobs)
+	{
+	  if (start_compile_job (next_to_start, &jobs[next_to_start],
+				 explicit_link_files))
+	    running++;
+	  next_to_start++;
+	}
+
+      /* Report the files which are done, in order.  */
+      while (next_to_finish < next_to_start && jobs[next_to_finish].finished)
+	{
+	  if (finish_compile_job (next_to_finish, &jobs[next_to_finish]))
+	    failures++;
+	  next_to_finish++;
+	}
+
+      if (running > 0)
+	{
+	  int status;
+	  int pid = wait (&status);
+	  int k;
+
+	  if (pid < 0)
+	    pfatal_with_name ("wait");
+
+	  for (k = next_to_finish; k < next_to_start; k++)
+	    if (jobs[k].pid == pid && ! jobs[k].finished)
+	      {
+		jobs[k].finished = 1;
+		jobs[k].status = status;
+		running--;
+		break;
+	      }
+	}
+    }
+
+  free (jobs);
+  return failures;
+}
+
+#endif /* HAVE_PARALLEL_COMPILES */
+
 /* On fatal signals, delete all the temporary files.  */
 
 static void
@@ -4648,7 +5021,6 @@ main (argc, argv)
      char **argv;
 {
   register size_t i;
-  size_t j;
   int value;
   int linker_was_run = 0;
   char *explicit_link_files;
@@ -5020,95 +5392,14 @@ main (argc, argv)
   explicit_link_files = xmalloc (n_infiles);
   bzero (explicit_link_files, n_infiles);
 
-  for (i = 0; (int)i < n_infiles; i++)
-    {
-      register struct compiler *cp = 0;
-      int this_file_error = 0;
-
-      /* Tell do_spec what to substitute for %i.  */
-
-      input_filename = infiles[i].name;
-      input_filename_length = strlen (input_filename);
-      input_file_number = i;
-
-      /* Use the same thing in %o, unless cp->spec says otherwise.  */
-
-      outfiles[i] = input_filename;
-
-      /* Figure out which compiler from the file's suffix.  */
-
-      cp = lookup_compiler (infiles[i].name, input_filename_length,
-			    infiles[i].language);
-
-      if (cp)
-	{
-	  /* Ok, we found an applicable compiler.  Run its spec.  */
-	  /* First say how much of input_filename to substitute for %b  */
-	  register const char *p;
-	  int len;
-
-	  if (cp->spec[0][0] == '#')
-	    error ("%s: %s compiler not installed on this system",
-		   input_filename, &cp->spec[0][1]);
-
-	  input_basename = input_filename;
-	  for (p = input_filename; *p; p++)
-	    if (IS_DIR_SEPARATOR (*p))
-	      input_basename = p + 1;
-
-	  /* Find a suffix starting with the last period,
-	     and set basename_length to exclude that suffix.  */
-	  basename_length = strlen (input_basename);
-	  p = input_basename + basename_length;
-	  while (p != input_basename && *p != '.') --p;
-	  if (*p == '.' && p != input_basename)
-	    {
-	      basename_length = p - input_basename;
-	      input_suffix = p + 1;
-	    }
-	  else
-	    input_suffix = "";
-
-	  len = 0;
-	  for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
-	    if (cp->spec[j])
-	      len += strlen (cp->spec[j]);
-
-	  {
-	    char *p1 = (char *) xmalloc (len + 1);
-	    
-	    len = 0;
-	    for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
-	      if (cp->spec[j])
-		{
-		  strcpy (p1 + len, cp->spec[j]);
-		  len += strlen (cp->spec[j]);
-		}
-	    
-	    value = do_spec (p1);
-	    free (p1);
-	  }
-	  if (value < 0)
-	    this_file_error = 1;
-	}
-
-      /* If this file's name does not contain a recognized suffix,
-	 record it as explicit linker input.  */
-
-      else
-	explicit_link_files[i] = 1;
-
-      /* Clear the delete-on-failure queue, deleting the files in it
-	 if this compilation failed.  */
-
-      if (this_file_error)
-	{
-	  delete_failure_queue ();
-	  error_count++;
-	}
-      /* If this compilation succeeded, don't delete those files later.  */
-      clear_failure_queue ();
-    }
+#ifdef HAVE_PARALLEL_COMPILES
+  if (n_jobs > 1 && n_infiles > 1)
+    error_count += compile_files_in_parallel (explicit_link_files);
+  else
+#endif
+    for (i = 0; (int)i < n_infiles; i++)
+      if (compile_input_file (i, explicit_link_files))
+	error_count++;
 
   if (error_count == 0)
     {
@@ -287,7 +287,7 @@ layout_decl (decl, known_align)
 	DECL_ALIGN (decl) = MIN (DECL_ALIGN (decl), BITS_PER_UNIT);
     }
 
-  if (DECL_BIT_FIELD (decl)
+  if (code == FIELD_DECL && DECL_BIT_FIELD (decl)
       && TYPE_SIZE (type) != 0
       && TREE_CODE (TYPE_SIZE (type)) == INTEGER_CST
       && GET_MODE_CLASS (TYPE_MODE (type)) == MODE_INT)
@@ -307,8 +307,10 @@ layout_decl (decl, known_align)
 	}
     }
 
-  /* Turn off DECL_BIT_FIELD if we won't need it set.  */
-  if (DECL_BIT_FIELD (decl) && TYPE_MODE (type) == BLKmode
+  /* Turn off DECL_BIT_FIELD if we won't need it set.  Other kinds of decl
+     use the same bit for other things, such as DECL_IN_TEXT_SECTION.  */
+  if (code == FIELD_DECL && DECL_BIT_FIELD (decl)
+      && TYPE_MODE (type) == BLKmode
       && known_align % TYPE_ALIGN (type) == 0
       && DECL_SIZE (decl) != 0
       && (TREE_CODE (DECL_SIZE (decl)) != INTEGER_CST
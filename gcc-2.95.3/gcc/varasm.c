@@ -61,6 +61,12 @@ Boston, MA 02111-1307, USA.  */
 #define ASM_STABS_OP ".stabs"
 #endif
 
+/* Nonzero if references to DECL are known to resolve to DECL itself,
+   rather than to a definition in another module that preempts it.  */
+#ifndef BINDS_LOCAL_P
+#define BINDS_LOCAL_P(DECL) (! TREE_PUBLIC (DECL))
+#endif
+
 /* Define the prefix to use when check_memory_usage_flag is enable.  */
 #ifdef NO_DOLLAR_IN_LABEL
 #ifdef NO_DOT_IN_LABEL
@@ -3864,16 +3870,33 @@ output_addressed_constants (exp)
 	  /* No need to do anything here
 	     for addresses of variables or functions.  */
 	  output_constant_def (constant);
+
+	/* A reloc against a symbol that may be preempted by another
+	   module counts as 2, and one against a local symbol as 1.  */
+	if (TREE_CODE_CLASS (TREE_CODE (constant)) == 'd'
+	    && ! BINDS_LOCAL_P (constant))
+	  reloc = 2;
+	else
+	  reloc = 1;
       }
-      reloc = 1;
       break;
 
     case PLUS_EXPR:
-    case MINUS_EXPR:
       reloc = output_addressed_constants (TREE_OPERAND (exp, 0));
       reloc |= output_addressed_constants (TREE_OPERAND (exp, 1));
       break;
 
+    case MINUS_EXPR:
+      {
+	int reloc0 = output_addressed_constants (TREE_OPERAND (exp, 0));
+	int reloc1 = output_addressed_constants (TREE_OPERAND (exp, 1));
+
+	/* The difference of two local addresses is computable at link
+	   time.  */
+	reloc = (reloc0 == 1 && reloc1 == 1) ? 0 : (reloc0 | reloc1);
+      }
+      break;
+
     case NOP_EXPR:
     case CONVERT_EXPR:
     case NON_LVALUE_EXPR:
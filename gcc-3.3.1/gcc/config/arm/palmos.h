@@ -20,9 +20,17 @@ Software Foundation, 59 Temple Place - Suite 330, Boston, MA
 
 /* Palm OS code must be PIC code, and the OS expects %r9 to be fixed.
    We could do the latter with SUBTARGET_CONDITIONAL_REGISTER_USAGE instead,
-   but this is more visible for our paranoid users.  */
+   but this is more visible for our paranoid users.  Fixing %r9 covers Thumb
+   code too:  it is never allocated, nor saved and restored by prologues.
+
+   PACE always calls an armlet in ARM state, so Thumb code is useless unless
+   it can interwork; we make -mthumb imply -mthumb-interwork, both for the
+   compiler and so that the assembler marks the object file accordingly.  */
 #undef CC1_SPEC
-#define CC1_SPEC  "-fPIC -ffixed-r9"
+#define CC1_SPEC  "-fPIC -ffixed-r9 %{mthumb:-mthumb-interwork}"
+
+#undef SUBTARGET_EXTRA_ASM_SPEC
+#define SUBTARGET_EXTRA_ASM_SPEC  "%{mthumb:%{!mthumb-interwork:-mthumb-interwork}}"
 
 #define SUBTARGET_CPU_DEFAULT  TARGET_CPU_arm7tdmi
 
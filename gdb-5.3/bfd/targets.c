@@ -664,6 +664,7 @@ extern const bfd_target pc532netbsd_vec;
 extern const bfd_target pdp11_aout_vec;
 extern const bfd_target pmac_xcoff_vec;
 extern const bfd_target ppcboot_vec;
+extern const bfd_target prc_littlearm_vec;
 extern const bfd_target riscix_vec;
 extern const bfd_target rs6000coff64_vec;
 extern const bfd_target rs6000coff_vec;
@@ -987,6 +988,7 @@ static const bfd_target * const _bfd_target_vector[] = {
 	&pmac_xcoff_vec,
 #endif
 	&ppcboot_vec,
+	&prc_littlearm_vec,
 #if 0
 	/* We have no way of distinguishing these from other a.out variants */
 	&riscix_vec,
@@ -549,6 +549,7 @@ dbx_symfile_read (struct objfile *objfile, int mainline)
   bfd *sym_bfd;
   int val;
   struct cleanup *back_to;
+  int minimal_symbol_count;
 
   sym_bfd = objfile->obfd;
 
@@ -583,6 +584,14 @@ dbx_symfile_read (struct objfile *objfile, int mainline)
   symbol_size = DBX_SYMBOL_SIZE (objfile);
   symbol_table_offset = DBX_SYMTAB_OFFSET (objfile);
 
+  /* The psymtabs may be in the symbol cache from an earlier session,
+     in which case there is no need to scan the stabs at all.  */
+  if (symcache_read_psymtabs (objfile, sizeof (struct symloc),
+			      dbx_psymtab_to_symtab))
+    return;
+
+  minimal_symbol_count = objfile->minimal_symbol_count;
+
   free_pending_blocks ();
   back_to = make_cleanup (really_free_pendings, 0);
 
@@ -603,6 +612,13 @@ dbx_symfile_read (struct objfile *objfile, int mainline)
   install_minimal_symbols (objfile);
 
   do_cleanups (back_to);
+
+  /* Save the psymtabs for next time, unless the stabs also gave us
+     minimal symbols: those are not cached, so this objfile has to be
+     read the long way every time.  */
+  if (objfile->minimal_symbol_count == minimal_symbol_count)
+    symcache_write_psymtabs (objfile, sizeof (struct symloc),
+			     dbx_psymtab_to_symtab);
 }
 
 /* Initialize anything that needs initializing when a completely new
@@ -3423,6 +3439,11 @@ coffstab_build_psymtabs (struct objfile *objfile, int mainline,
     }
 
   dbx_symfile_read (objfile, 0);
+
+  /* Scanning the stabs uses up the section list, but if the psymtabs
+     came from the symbol cache it is still here; drop it, since
+     reading individual psymtabs later works from file offsets.  */
+  symbuf_sections = NULL;
 }
 
 /* Scan and build partial symbols for an ELF symbol file.
@@ -0,0 +1,782 @@
+/* Persistent cache of partial symbol tables, for GDB.
+
+   Copyright 2003 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+/* Scanning the stabs of a big executable to build its partial symbol
+   tables is the slowest part of starting GDB on it, and the result
+   depends only on the contents of the executable.  So the first time
+   we read an executable we write its psymtabs out to a file named by
+   the MD5 checksum of the executable, in the directory given by
+   `set symbol-cache-directory'; later sessions map that file and
+   rebuild the psymtabs from it without looking at the stabs at all.
+
+   The file is a straight dump of host-format structures, so it is
+   only usable by the same GDB on the same kind of host.  Anything
+   that doesn't match exactly -- checksum, format version, structure
+   sizes, section offsets -- makes us ignore the file and read the
+   symbols the usual way, after which the file is rewritten.  The
+   header also carries an MD5 checksum of everything after it, so a
+   truncated or damaged file is rebuilt rather than trusted.
+
+   Only the stabs reader uses the cache, so it helps only programs
+   compiled with -gstabs; DWARF 2 symbols are read as before.  Full
+   symtabs, and with them line tables, are still built lazily from
+   the stabs when a psymtab is expanded; only the scan is saved.
+
+   Nothing removes old cache files, so the cache is off unless the
+   user asks for it with `set symbol-cache on'.  */
+
+#include "defs.h"
+#include "symtab.h"
+#include "symfile.h"
+#include "objfiles.h"
+#include "gdbcmd.h"
+#include "completer.h"
+#include "gdb_obstack.h"
+#include "gdb_string.h"
+#include "gdb_stat.h"
+#include "md5.h"
+
+#include <fcntl.h>
+#include <errno.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#define SYMCACHE_MAGIC "GDBPSYM"
+#define SYMCACHE_VERSION 2
+
+/* Non-zero if the cache is to be used at all (`set symbol-cache').  */
+
+static int symbol_cache = 0;
+
+/* Directory holding the cache files.  */
+
+static char *symbol_cache_directory;
+
+/* The layout of a cache file is: the header, the objfile's section
+   offsets, the psymtab records, the global and then the static
+   partial symbol records, the psymtab dependency indexes, each
+   psymtab's reader-private data, and finally the string table that
+   all names are offsets into.  This order keeps every array aligned
+   for direct access from the mapped file.  */
+
+struct symcache_header
+  {
+    char magic[8];
+    unsigned int version;
+    unsigned char checksum[16];
+
+    /* MD5 checksum of the rest of the file.  */
+    unsigned char contents_checksum[16];
+
+    /* Sizes of the host types the file was written with.  */
+    unsigned int sizeof_core_addr;
+    unsigned int sizeof_long;
+    unsigned int private_size;
+
+    unsigned int num_sections;
+    CORE_ADDR entry_file_lowpc;
+    CORE_ADDR entry_file_highpc;
+
+    unsigned int n_psymtabs;
+    unsigned int n_global_psymbols;
+    unsigned int n_static_psymbols;
+    unsigned int n_dependencies;
+    unsigned int strings_size;
+  };
+
+struct symcache_psymtab
+  {
+    CORE_ADDR textlow;
+    CORE_ADDR texthigh;
+    unsigned int filename;
+    int globals_offset;
+    int n_global_syms;
+    int statics_offset;
+    int n_static_syms;
+    unsigned int first_dependency;
+    unsigned int number_of_dependencies;
+  };
+
+struct symcache_psymbol
+  {
+    CORE_ADDR value;
+    unsigned int name;
+    unsigned char namespace;
+    unsigned char aclass;
+    unsigned char language;
+  };
+
+/* Write N items of SIZE bytes from PTR to F, adding them to the
+   running checksum CTX.  Return non-zero on success.  */
+
+static int
+symcache_fwrite (const void *ptr, size_t size, size_t n, FILE *f,
+		 struct md5_ctx *ctx)
+{
+  md5_process_bytes (ptr, size * n, ctx);
+  return fwrite (ptr, size, n, f) == n;
+}
+
+/* Compute the MD5 checksum of OBJFILE's file into CHECKSUM.  Return
+   zero if the file can't be read.  */
+
+static int
+symcache_checksum (struct objfile *objfile, unsigned char *checksum)
+{
+  FILE *f;
+  int ok;
+
+  f = fopen (objfile->name, FOPEN_RB);
+  if (f == NULL)
+    return 0;
+
+  ok = (md5_stream (f, checksum) == 0);
+  fclose (f);
+  return ok;
+}
+
+/* Return the xmalloc'd name of the cache file for CHECKSUM.  */
+
+static char *
+symcache_filename (const unsigned char *checksum)
+{
+  char *name, *p;
+  int i;
+
+  name = xmalloc (strlen (symbol_cache_directory) + 1 + 32 + 1);
+  p = name + sprintf (name, "%s/", symbol_cache_directory);
+  for (i = 0; i < 16; i++)
+    p += sprintf (p, "%02x", checksum[i]);
+
+  return name;
+}
+
+static int
+symcache_enabled (struct objfile *objfile)
+{
+  return (symbol_cache
+	  && symbol_cache_directory != NULL
+	  && objfile->name != NULL);
+}
+
+/* A string table being accumulated for writing.  */
+
+struct symcache_strings
+  {
+    char *buf;
+    unsigned int size;
+    unsigned int allocated;
+  };
+
+static unsigned int
+symcache_add_string (struct symcache_strings *strings, const char *s)
+{
+  unsigned int len = strlen (s) + 1;
+  unsigned int offset = strings->size;
+
+  if (strings->size + len > strings->allocated)
+    {
+      strings->allocated = 2 * strings->allocated + len;
+      strings->buf = xrealloc (strings->buf, strings->allocated);
+    }
+
+  memcpy (strings->buf + offset, s, len);
+  strings->size += len;
+  return offset;
+}
+
+static void
+symcache_free_strings (void *arg)
+{
+  struct symcache_strings *strings = (struct symcache_strings *) arg;
+  xfree (strings->buf);
+}
+
+/* Fill in the psymbol record OUT from PSYM.  */
+
+static void
+symcache_pack_psymbol (struct symcache_psymbol *out,
+		       struct partial_symbol *psym,
+		       struct symcache_strings *strings)
+{
+  memset (out, 0, sizeof (*out));
+  out->name = symcache_add_string (strings, SYMBOL_NAME (psym));
+  if (PSYMBOL_CLASS (psym) == LOC_CONST)
+    out->value = (CORE_ADDR) SYMBOL_VALUE (psym);
+  else
+    out->value = SYMBOL_VALUE_ADDRESS (psym);
+  out->namespace = PSYMBOL_NAMESPACE (psym);
+  out->aclass = PSYMBOL_CLASS (psym);
+  out->language = SYMBOL_LANGUAGE (psym);
+}
+
+/* Psymtabs sorted by address, to map dependency pointers back to
+   the order the psymtabs are written in.  */
+
+struct symcache_index
+  {
+    struct partial_symtab *pst;
+    unsigned int index;
+  };
+
+static int
+compare_symcache_index (const void *ap, const void *bp)
+{
+  const struct partial_symtab *a = ((const struct symcache_index *) ap)->pst;
+  const struct partial_symtab *b = ((const struct symcache_index *) bp)->pst;
+
+  return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+/* Write the partial symbol tables that have just been read for OBJFILE
+   to its cache file.  They must all have been made by the reader whose
+   expansion function is READ_SYMTAB; PRIVATE_SIZE is the size of its
+   read_symtab_private data, which is saved as an opaque block.
+   Failure is not an error: we just don't get a cache file.  */
+
+void
+symcache_write_psymtabs (struct objfile *objfile, int private_size,
+			 void (*read_symtab) (struct partial_symtab *))
+{
+  struct symcache_header header;
+  struct symcache_strings strings;
+  struct partial_symtab *pst, **psymtabs;
+  struct symcache_index *sorted;
+  struct symcache_psymtab *records;
+  struct symcache_psymbol record;
+  unsigned int *dependencies;
+  struct md5_ctx ctx;
+  struct cleanup *back_to;
+  char *filename, *tmpname;
+  unsigned int i, j, n_dependencies;
+  FILE *f;
+  int ok;
+
+  if (!symcache_enabled (objfile))
+    return;
+
+  memset (&header, 0, sizeof (header));
+  if (!symcache_checksum (objfile, header.checksum))
+    return;
+
+  strncpy (header.magic, SYMCACHE_MAGIC, sizeof (header.magic));
+  header.version = SYMCACHE_VERSION;
+  header.sizeof_core_addr = sizeof (CORE_ADDR);
+  header.sizeof_long = sizeof (long);
+  header.private_size = private_size;
+  header.num_sections = objfile->num_sections;
+  header.entry_file_lowpc = objfile->ei.entry_file_lowpc;
+  header.entry_file_highpc = objfile->ei.entry_file_highpc;
+  header.n_global_psymbols =
+    objfile->global_psymbols.next - objfile->global_psymbols.list;
+  header.n_static_psymbols =
+    objfile->static_psymbols.next - objfile->static_psymbols.list;
+
+  /* Psymtabs are chained most recent first, and allocate_psymtab
+     prepends, so record them oldest first to get the same chain back.  */
+  header.n_psymtabs = 0;
+  ALL_OBJFILE_PSYMTABS (objfile, pst)
+    header.n_psymtabs++;
+
+  psymtabs = (struct partial_symtab **)
+    xmalloc ((header.n_psymtabs + 1) * sizeof (struct partial_symtab *));
+  back_to = make_cleanup (xfree, psymtabs);
+  i = header.n_psymtabs;
+  ALL_OBJFILE_PSYMTABS (objfile, pst)
+    {
+      /* The partial symbol lists are saved wholesale, so give up if
+         any other reader has contributed to them.  */
+      if (pst->read_symtab != read_symtab
+	  || pst->section_offsets != objfile->section_offsets
+	  || pst->readin || pst->read_symtab_private == NULL)
+	{
+	  do_cleanups (back_to);
+	  return;
+	}
+      psymtabs[--i] = pst;
+    }
+
+  /* Dependencies are recorded as indexes into PSYMTABS.  */
+  sorted = (struct symcache_index *)
+    xmalloc ((header.n_psymtabs + 1) * sizeof (struct symcache_index));
+  make_cleanup (xfree, sorted);
+  for (i = 0; i < header.n_psymtabs; i++)
+    {
+      sorted[i].pst = psymtabs[i];
+      sorted[i].index = i;
+    }
+  qsort (sorted, header.n_psymtabs, sizeof (*sorted),
+	 compare_symcache_index);
+
+  n_dependencies = 0;
+  for (i = 0; i < header.n_psymtabs; i++)
+    n_dependencies += psymtabs[i]->number_of_dependencies;
+  header.n_dependencies = n_dependencies;
+
+  records = (struct symcache_psymtab *)
+    xmalloc ((header.n_psymtabs + 1) * sizeof (struct symcache_psymtab));
+  make_cleanup (xfree, records);
+  dependencies = (unsigned int *)
+    xmalloc ((n_dependencies + 1) * sizeof (unsigned int));
+  make_cleanup (xfree, dependencies);
+
+  memset (&strings, 0, sizeof (strings));
+  make_cleanup (symcache_free_strings, &strings);
+
+  n_dependencies = 0;
+  for (i = 0; i < header.n_psymtabs; i++)
+    {
+      pst = psymtabs[i];
+      memset (&records[i], 0, sizeof (records[i]));
+      records[i].textlow = pst->textlow;
+      records[i].texthigh = pst->texthigh;
+      records[i].filename = symcache_add_string (&strings, pst->filename);
+      records[i].globals_offset = pst->globals_offset;
+      records[i].n_global_syms = pst->n_global_syms;
+      records[i].statics_offset = pst->statics_offset;
+      records[i].n_static_syms = pst->n_static_syms;
+      records[i].first_dependency = n_dependencies;
+      records[i].number_of_dependencies = pst->number_of_dependencies;
+
+      for (j = 0; j < pst->number_of_dependencies; j++)
+	{
+	  struct symcache_index key, *found;
+
+	  key.pst = pst->dependencies[j];
+	  found = (struct symcache_index *)
+	    bsearch (&key, sorted, header.n_psymtabs, sizeof (*sorted),
+		     compare_symcache_index);
+	  if (found == NULL)
+	    {
+	      /* Depends on a psymtab that was discarded.  */
+	      do_cleanups (back_to);
+	      return;
+	    }
+	  dependencies[n_dependencies++] = found->index;
+	}
+    }
+
+  filename = symcache_filename (header.checksum);
+  make_cleanup (xfree, filename);
+  tmpname = xmalloc (strlen (filename) + 32);
+  make_cleanup (xfree, tmpname);
+  sprintf (tmpname, "%s.%ld", filename, (long) getpid ());
+
+  mkdir (symbol_cache_directory, 0777);
+  f = fopen (tmpname, FOPEN_WB);
+  if (f == NULL)
+    {
+      if (info_verbose)
+	printf_filtered ("Can't create symbol cache file %s: %s\n",
+			 tmpname, safe_strerror (errno));
+      do_cleanups (back_to);
+      return;
+    }
+
+  /* The header is rewritten at the end, once the size of the string
+     table and the checksum of the contents are known.  */
+  md5_init_ctx (&ctx);
+  ok = fwrite (&header, sizeof (header), 1, f) == 1;
+  if (header.num_sections > 0)
+    ok &= symcache_fwrite (objfile->section_offsets->offsets,
+			   sizeof (CORE_ADDR), header.num_sections, f, &ctx);
+  if (header.n_psymtabs > 0)
+    ok &= symcache_fwrite (records, sizeof (*records), header.n_psymtabs,
+			   f, &ctx);
+
+  for (i = 0; ok && i < header.n_global_psymbols; i++)
+    {
+      symcache_pack_psymbol (&record, objfile->global_psymbols.list[i],
+			     &strings);
+      ok = symcache_fwrite (&record, sizeof (record), 1, f, &ctx);
+    }
+  for (i = 0; ok && i < header.n_static_psymbols; i++)
+    {
+      symcache_pack_psymbol (&record, objfile->static_psymbols.list[i],
+			     &strings);
+      ok = symcache_fwrite (&record, sizeof (record), 1, f, &ctx);
+    }
+
+  if (ok && n_dependencies > 0)
+    ok = symcache_fwrite (dependencies, sizeof (unsigned int),
+			  n_dependencies, f, &ctx);
+  for (i = 0; ok && i < header.n_psymtabs && private_size > 0; i++)
+    ok = symcache_fwrite (psymtabs[i]->read_symtab_private, private_size,
+			  1, f, &ctx);
+
+  header.strings_size = strings.size;
+  if (ok && strings.size > 0)
+    ok = symcache_fwrite (strings.buf, 1, strings.size, f, &ctx);
+
+  md5_finish_ctx (&ctx, header.contents_checksum);
+  if (ok)
+    ok = (fseek (f, 0L, SEEK_SET) == 0
+	  && fwrite (&header, sizeof (header), 1, f) == 1);
+
+  if (fclose (f) != 0)
+    ok = 0;
+
+  /* Rename into place so that a concurrent GDB never maps a file
+     that is still being written.  */
+  if (ok && rename (tmpname, filename) == 0)
+    {
+      if (info_verbose)
+	printf_filtered ("Wrote symbol cache file %s\n", filename);
+    }
+  else
+    unlink (tmpname);
+
+  do_cleanups (back_to);
+}
+
+/* A cache file's contents, either mapped or read into memory.  */
+
+struct symcache_file
+  {
+    char *contents;
+    size_t size;
+    int mapped;
+  };
+
+static void
+symcache_release (void *arg)
+{
+  struct symcache_file *file = (struct symcache_file *) arg;
+
+#ifdef HAVE_MMAP
+  if (file->mapped)
+    {
+      munmap (file->contents, file->size);
+      return;
+    }
+#endif
+  xfree (file->contents);
+}
+
+static int
+symcache_open (char *filename, struct symcache_file *file)
+{
+  struct stat st;
+  int fd;
+
+  fd = open (filename, O_RDONLY | O_BINARY);
+  if (fd < 0)
+    return 0;
+
+  if (fstat (fd, &st) < 0 || st.st_size < (off_t) sizeof (struct symcache_header))
+    {
+      close (fd);
+      return 0;
+    }
+
+  file->size = st.st_size;
+  file->mapped = 0;
+
+#ifdef HAVE_MMAP
+  file->contents = mmap (NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (file->contents != (char *) MAP_FAILED)
+    {
+      file->mapped = 1;
+      close (fd);
+      return 1;
+    }
+#endif
+
+  file->contents = xmalloc (file->size);
+  if (read (fd, file->contents, file->size) != (ssize_t) file->size)
+    {
+      xfree (file->contents);
+      close (fd);
+      return 0;
+    }
+
+  close (fd);
+  return 1;
+}
+
+/* Allocate LIST, one of OBJFILE's partial symbol lists, with room for
+   exactly N symbols.  */
+
+static void
+symcache_alloc_psymbol_list (struct objfile *objfile,
+			     struct psymbol_allocation_list *list,
+			     unsigned int n)
+{
+  if (list->list)
+    xmfree (objfile->md, (PTR) list->list);
+
+  list->size = (n > 0) ? n : 1;
+  list->next = list->list = (struct partial_symbol **)
+    xmmalloc (objfile->md, list->size * sizeof (struct partial_symbol *));
+}
+
+/* Rebuild OBJFILE's partial symbol tables from its cache file, setting
+   each psymtab's read_symtab to READ_SYMTAB and copying PRIVATE_SIZE
+   bytes of reader-private data into it.  Return non-zero on success,
+   or zero (having changed nothing) if there is no usable cache file,
+   in which case the caller should read the symbols itself and then
+   call symcache_write_psymtabs.  */
+
+int
+symcache_read_psymtabs (struct objfile *objfile, int private_size,
+			void (*read_symtab) (struct partial_symtab *))
+{
+  unsigned char checksum[16], contents_checksum[16];
+  struct symcache_header header;
+  struct symcache_file file;
+  struct symcache_psymtab *records;
+  struct symcache_psymbol *psymbols;
+  struct partial_symtab **psymtabs;
+  struct partial_symbol *psyms;
+  unsigned int *dependencies;
+  char *private, *strings, *names;
+  struct cleanup *back_to;
+  char *filename;
+  size_t expected;
+  unsigned int i, j, n_psymbols;
+
+  if (!symcache_enabled (objfile)
+      || objfile->psymtabs != NULL
+      || objfile->global_psymbols.next != objfile->global_psymbols.list
+      || objfile->static_psymbols.next != objfile->static_psymbols.list)
+    return 0;
+
+  if (!symcache_checksum (objfile, checksum))
+    return 0;
+
+  filename = symcache_filename (checksum);
+  back_to = make_cleanup (xfree, filename);
+  if (!symcache_open (filename, &file))
+    {
+      do_cleanups (back_to);
+      return 0;
+    }
+  make_cleanup (symcache_release, &file);
+
+  /* Check everything before touching OBJFILE, so that a bad file
+     leaves us free to fall back on reading the symbols normally.  */
+  memcpy (&header, file.contents, sizeof (header));
+  if (strncmp (header.magic, SYMCACHE_MAGIC, sizeof (header.magic)) != 0
+      || header.version != SYMCACHE_VERSION
+      || memcmp (header.checksum, checksum, sizeof (checksum)) != 0
+      || header.sizeof_core_addr != sizeof (CORE_ADDR)
+      || header.sizeof_long != sizeof (long)
+      || header.private_size != private_size
+      || header.num_sections != objfile->num_sections)
+    goto mismatch;
+
+  n_psymbols = header.n_global_psymbols + header.n_static_psymbols;
+  expected = (sizeof (header)
+	      + header.num_sections * sizeof (CORE_ADDR)
+	      + header.n_psymtabs * sizeof (struct symcache_psymtab)
+	      + (size_t) n_psymbols * sizeof (struct symcache_psymbol)
+	      + header.n_dependencies * sizeof (unsigned int)
+	      + header.n_psymtabs * (size_t) private_size
+	      + header.strings_size);
+  if (expected != file.size
+      || (header.strings_size > 0
+	  && file.contents[file.size - 1] != '\0'))
+    goto mismatch;
+
+  md5_buffer (file.contents + sizeof (header), file.size - sizeof (header),
+	      contents_checksum);
+  if (memcmp (header.contents_checksum, contents_checksum,
+	      sizeof (contents_checksum)) != 0)
+    goto mismatch;
+
+  if (header.num_sections > 0
+      && memcmp (file.contents + sizeof (header),
+		 objfile->section_offsets->offsets,
+		 header.num_sections * sizeof (CORE_ADDR)) != 0)
+    goto mismatch;
+
+  records = (struct symcache_psymtab *)
+    (file.contents + sizeof (header)
+     + header.num_sections * sizeof (CORE_ADDR));
+  psymbols = (struct symcache_psymbol *) (records + header.n_psymtabs);
+  dependencies = (unsigned int *) (psymbols + n_psymbols);
+  private = (char *) (dependencies + header.n_dependencies);
+  strings = private + header.n_psymtabs * private_size;
+
+  for (i = 0; i < header.n_psymtabs; i++)
+    {
+      struct symcache_psymtab *r = &records[i];
+
+      if (r->filename >= header.strings_size
+	  || r->globals_offset < 0 || r->n_global_syms < 0
+	  || r->statics_offset < 0 || r->n_static_syms < 0
+	  || (unsigned int) r->globals_offset + r->n_global_syms
+	     > header.n_global_psymbols
+	  || (unsigned int) r->statics_offset + r->n_static_syms
+	     > header.n_static_psymbols
+	  || r->first_dependency > header.n_dependencies
+	  || r->number_of_dependencies
+	     > header.n_dependencies - r->first_dependency)
+	goto mismatch;
+    }
+  for (i = 0; i < header.n_dependencies; i++)
+    if (dependencies[i] >= header.n_psymtabs)
+      goto mismatch;
+  for (i = 0; i < n_psymbols; i++)
+    if (psymbols[i].name >= header.strings_size)
+      goto mismatch;
+
+  /* The file is good; rebuild the psymtabs from it.  The partial
+     symbols are built directly on the psymbol obstack rather than
+     going through add_psymbol_to_list, whose hashing into the bcache
+     would cost about as much as scanning the stabs did; the names all
+     point into a single copy of the string table.  */
+
+  symcache_alloc_psymbol_list (objfile, &objfile->global_psymbols,
+			       header.n_global_psymbols);
+  symcache_alloc_psymbol_list (objfile, &objfile->static_psymbols,
+			       header.n_static_psymbols);
+
+  names = (char *) obstack_alloc (&objfile->psymbol_obstack,
+				  header.strings_size + 1);
+  memcpy (names, strings, header.strings_size);
+  psyms = (struct partial_symbol *)
+    obstack_alloc (&objfile->psymbol_obstack,
+		   (n_psymbols + 1) * sizeof (struct partial_symbol));
+  memset (psyms, 0, n_psymbols * sizeof (struct partial_symbol));
+
+  for (i = 0; i < n_psymbols; i++)
+    {
+      struct symcache_psymbol *p = &psymbols[i];
+      struct partial_symbol *psym = &psyms[i];
+      struct psymbol_allocation_list *list;
+
+      SYMBOL_NAME (psym) = names + p->name;
+      if (p->aclass == LOC_CONST)
+	SYMBOL_VALUE (psym) = (long) p->value;
+      else
+	SYMBOL_VALUE_ADDRESS (psym) = p->value;
+      SYMBOL_LANGUAGE (psym) = (enum language) p->language;
+      PSYMBOL_NAMESPACE (psym) = (namespace_enum) p->namespace;
+      PSYMBOL_CLASS (psym) = (enum address_class) p->aclass;
+      SYMBOL_INIT_LANGUAGE_SPECIFIC (psym, SYMBOL_LANGUAGE (psym));
+
+      list = (i < header.n_global_psymbols
+	      ? &objfile->global_psymbols : &objfile->static_psymbols);
+      *list->next++ = psym;
+    }
+  OBJSTAT (objfile, n_psyms += n_psymbols);
+
+  psymtabs = (struct partial_symtab **)
+    xmalloc ((header.n_psymtabs + 1) * sizeof (struct partial_symtab *));
+  make_cleanup (xfree, psymtabs);
+
+  for (i = 0; i < header.n_psymtabs; i++)
+    {
+      struct symcache_psymtab *r = &records[i];
+      struct partial_symtab *pst;
+
+      pst = allocate_psymtab (strings + r->filename, objfile);
+      pst->section_offsets = objfile->section_offsets;
+      pst->textlow = r->textlow;
+      pst->texthigh = r->texthigh;
+      pst->globals_offset = r->globals_offset;
+      pst->n_global_syms = r->n_global_syms;
+      pst->statics_offset = r->statics_offset;
+      pst->n_static_syms = r->n_static_syms;
+      pst->read_symtab = read_symtab;
+      pst->read_symtab_private = (char *)
+	obstack_alloc (&objfile->psymbol_obstack, private_size);
+      memcpy (pst->read_symtab_private, private + i * private_size,
+	      private_size);
+      psymtabs[i] = pst;
+    }
+
+  for (i = 0; i < header.n_psymtabs; i++)
+    {
+      struct symcache_psymtab *r = &records[i];
+      struct partial_symtab *pst = psymtabs[i];
+
+      pst->number_of_dependencies = r->number_of_dependencies;
+      if (r->number_of_dependencies == 0)
+	continue;
+
+      pst->dependencies = (struct partial_symtab **)
+	obstack_alloc (&objfile->psymbol_obstack,
+		       r->number_of_dependencies
+		       * sizeof (struct partial_symtab *));
+      for (j = 0; j < r->number_of_dependencies; j++)
+	pst->dependencies[j] =
+	  psymtabs[dependencies[r->first_dependency + j]];
+    }
+
+  objfile->ei.entry_file_lowpc = header.entry_file_lowpc;
+  objfile->ei.entry_file_highpc = header.entry_file_highpc;
+
+  if (info_verbose)
+    printf_filtered ("Using symbol cache file %s\n", filename);
+
+  do_cleanups (back_to);
+  return 1;
+
+mismatch:
+  if (info_verbose)
+    printf_filtered ("Ignoring out of date symbol cache file %s\n", filename);
+  do_cleanups (back_to);
+  return 0;
+}
+
+void
+_initialize_symcache (void)
+{
+  struct cmd_list_element *c;
+  char *home;
+
+  home = getenv ("HOME");
+  if (home != NULL && home[0] != '\0')
+    {
+      symbol_cache_directory = xmalloc (strlen (home) + sizeof ("/.gdb-symcache"));
+      strcpy (symbol_cache_directory, home);
+      strcat (symbol_cache_directory, "/.gdb-symcache");
+    }
+
+  c = add_set_cmd ("symbol-cache-directory", class_support, var_filename,
+		   (char *) &symbol_cache_directory,
+		   "Set the directory where partial symbol tables are cached.",
+		   &setlist);
+  add_show_from_set (c, &showlist);
+  set_cmd_completer (c, filename_completer);
+
+  add_show_from_set
+    (add_set_cmd ("symbol-cache", class_support, var_boolean,
+		  (char *) &symbol_cache,
+		  "Set caching of partial symbol tables between sessions.\n\
+The first time an executable's stabs are read, the partial symbol tables\n\
+built from them are saved in the symbol-cache-directory, keyed by the MD5\n\
+checksum of the executable.  Later sessions load them from there instead\n\
+of reading the stabs again.  Only stabs (-gstabs) debugging information\n\
+is cached.  Off by default, since old cache files are never removed.",
+		  &setlist),
+     &showlist);
+}
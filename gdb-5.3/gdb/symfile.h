@@ -295,6 +295,14 @@ extern void symbol_file_add_main (char *args, int from_tty);
 /* Clear GDB symbol tables. */
 extern void symbol_file_clear (int from_tty);
 
+/* From symcache.c */
+
+extern int symcache_read_psymtabs (struct objfile *, int,
+				   void (*) (struct partial_symtab *));
+
+extern void symcache_write_psymtabs (struct objfile *, int,
+				     void (*) (struct partial_symtab *));
+
 /* From dwarfread.c */
 
 extern void
@@ -29,7 +29,7 @@
 typedef char *VoidStar;
 #endif
 
-typedef unsigned long ARMword;	/* must be 32 bits wide */
+typedef unsigned int ARMword;	/* must be 32 bits wide */
 typedef unsigned long long ARMdword;	/* Must be at least 64 bits wide.  */
 typedef struct ARMul_State ARMul_State;
 
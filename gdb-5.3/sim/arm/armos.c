@@ -70,6 +70,7 @@ extern int _fisatty (FILE *);
 
 #include "armdefs.h"
 #include "armos.h"
+#include "palmos.h"
 #include "armemu.h"
 
 #ifndef NOOS
@@ -540,6 +541,10 @@ ARMul_OSHandleSWI (ARMul_State * state, ARMword number)
       state->Emulate = FALSE;
       break;
 
+    case SWI_PalmOS_Call68K:
+      ARMul_PalmOSCall68K (state);
+      break;
+
       /* Handle Angel SWIs as well as Demon ones.  */
     case AngelSWI_ARM:
     case AngelSWI_Thumb:
@@ -315,7 +315,7 @@ RDI_read (ARMword source, void *dest, unsigned *nbytes)
   char *memptr = (char *) dest;
 
   TracePrint ((state, "RDI_read: source=%.8lx dest=%p nbytes=%.8x\n",
-	       source, dest, *nbytes));
+	       (unsigned long) source, dest, *nbytes));
 
   for (i = 0; i < *nbytes; i++)
     *memptr++ = (char) ARMul_ReadByte (state, source++);
@@ -338,7 +338,7 @@ RDI_write (const void *source, ARMword dest, unsigned *nbytes)
   char *memptr = (char *) source;
 
   TracePrint ((state, "RDI_write: source=%p dest=%.8lx nbytes=%.8x\n",
-	       source, dest, *nbytes));
+	       source, (unsigned long) dest, *nbytes));
 
   for (i = 0; i < *nbytes; i++)
     ARMul_WriteByte (state, (ARMword) dest++, (ARMword) * memptr++);
@@ -393,7 +393,7 @@ RDI_CPUread (unsigned mode, unsigned long mask, ARMword buffer[])
 	if (mask & (1L << i))
 	  {
 	    ARMul_DebugPrint (state, "%c%.8lx", upto % 4 == 0 ? '\n' : ' ',
-			      buffer[upto]);
+			      (unsigned long) buffer[upto]);
 	    upto++;
 	  }
       ARMul_DebugPrint (state, "\n");
@@ -421,7 +421,7 @@ RDI_CPUwrite (unsigned mode, unsigned long mask, ARMword const buffer[])
 	if (mask & (1L << i))
 	  {
 	    ARMul_DebugPrint (state, "%c%.8lx", upto % 4 == 0 ? '\n' : ' ',
-			      buffer[upto]);
+			      (unsigned long) buffer[upto]);
 	    upto++;
 	  }
       ARMul_DebugPrint (state, "\n");
@@ -488,7 +488,8 @@ RDI_CPread (unsigned CPnum, unsigned long mask, ARMword buffer[])
 				  (w >= 4 ? (w = 0, '\n') : ' '), r);
 		while (--words >= 0)
 		  {
-		    ARMul_DebugPrint (state, " %.8lx", buffer[upto++]);
+		    ARMul_DebugPrint (state, " %.8lx",
+				      (unsigned long) buffer[upto++]);
 		    w++;
 		  }
 	      }
@@ -576,11 +577,15 @@ RDI_CPread (unsigned CPnum, unsigned long mask, ARMword buffer[])
 	  {
 	    if (r != 8)
 	      {
-		ARMul_DebugPrint (state, "%08lx ", buffer[upto++]);
-		ARMul_DebugPrint (state, "%08lx ", buffer[upto++]);
-		ARMul_DebugPrint (state, "%08lx ", buffer[upto++]);
+		ARMul_DebugPrint (state, "%08lx ",
+				  (unsigned long) buffer[upto++]);
+		ARMul_DebugPrint (state, "%08lx ",
+				  (unsigned long) buffer[upto++]);
+		ARMul_DebugPrint (state, "%08lx ",
+				  (unsigned long) buffer[upto++]);
 	      }
-	    ARMul_DebugPrint (state, "%08lx\n", buffer[upto++]);
+	    ARMul_DebugPrint (state, "%08lx\n",
+			      (unsigned long) buffer[upto++]);
 	  }
       ARMul_DebugPrint (state, "\n");
     }
@@ -618,7 +623,8 @@ RDI_CPwrite (unsigned CPnum, unsigned long mask, ARMword const buffer[])
 				  (w >= 4 ? (w = 0, '\n') : ' '), r);
 		while (--words >= 0)
 		  {
-		    ARMul_DebugPrint (state, " %.8lx", buffer[upto++]);
+		    ARMul_DebugPrint (state, " %.8lx",
+				      (unsigned long) buffer[upto++]);
 		    w++;
 		  }
 	      }
@@ -647,11 +653,15 @@ RDI_CPwrite (unsigned CPnum, unsigned long mask, ARMword const buffer[])
 	  {
 	    if (r != 8)
 	      {
-		ARMul_DebugPrint (state, "%08lx ", buffer[upto++]);
-		ARMul_DebugPrint (state, "%08lx ", buffer[upto++]);
-		ARMul_DebugPrint (state, "%08lx ", buffer[upto++]);
+		ARMul_DebugPrint (state, "%08lx ",
+				  (unsigned long) buffer[upto++]);
+		ARMul_DebugPrint (state, "%08lx ",
+				  (unsigned long) buffer[upto++]);
+		ARMul_DebugPrint (state, "%08lx ",
+				  (unsigned long) buffer[upto++]);
 	      }
-	    ARMul_DebugPrint (state, "%08lx\n", buffer[upto++]);
+	    ARMul_DebugPrint (state, "%08lx\n",
+			      (unsigned long) buffer[upto++]);
 	  }
       ARMul_DebugPrint (state, "\n");
     }
@@ -742,7 +752,7 @@ RDI_setbreak (ARMword address, unsigned type, ARMword bound,
 {
   BreakNode *p;
   TracePrint ((state, "RDI_setbreak: address=%.8lx type=%d bound=%.8lx\n",
-	       address, type, bound));
+	       (unsigned long) address, type, (unsigned long) bound));
 
   removebreak (address, type);
   p = installbreak (address, type, bound);
@@ -828,7 +838,8 @@ RDI_setwatch (ARMword address, unsigned type, unsigned datatype,
   TracePrint (
 	      (state,
 	       "RDI_setwatch: address=%.8lx type=%d datatype=%d bound=%.8lx",
-	       address, type, datatype, bound));
+	       (unsigned long) address, type, datatype,
+	       (unsigned long) bound));
 
   if (!state->CanWatch)
     return RDIError_UnimplementedMessage;
@@ -965,7 +976,7 @@ RDI_info (unsigned type, ARMword * arg1, ARMword * arg2)
       return RDIError_NoError;
 
     case RDIVector_Catch:
-      TracePrint ((state, "RDIVector_Catch %.8lx\n", *arg1));
+      TracePrint ((state, "RDIVector_Catch %.8lx\n", (unsigned long) *arg1));
       state->VectorCatch = (unsigned) *arg1;
       return RDIError_NoError;
 
@@ -994,7 +1005,7 @@ RDI_info (unsigned type, ARMword * arg1, ARMword * arg2)
 
     case RDIErrorP:
       *arg1 = ARMul_OSLastErrorP (state);
-      TracePrint ((state, "RDI_ErrorP returns %ld\n", *arg1));
+      TracePrint ((state, "RDI_ErrorP returns %ld\n", (long) *arg1));
       return RDIError_NoError;
 
     case RDIInfo_DescribeCoPro:
@@ -1107,7 +1118,7 @@ ARMul_Debug (ARMul_State * state, ARMword pc, ARMword instr)
 
   if (state->EndCondition == RDIError_UserInterrupt)
     {
-      TracePrint ((state, "User interrupt at %.8lx\n", pc));
+      TracePrint ((state, "User interrupt at %.8lx\n", (unsigned long) pc));
       state->CallDebug--;
       state->Emulate = STOP;
     }
@@ -1152,7 +1163,8 @@ ARMul_Debug (ARMul_State * state, ARMword pc, ARMword instr)
 	      continue;
 	    }
 	  /* found a match */
-	  TracePrint ((state, "Breakpoint reached at %.8lx\n", pc));
+	  TracePrint ((state, "Breakpoint reached at %.8lx\n",
+		       (unsigned long) pc));
 	  state->EndCondition = RDIError_BreakpointReached;
 	  state->Emulate = STOP;
 	  state->StopHandle = (ARMword) p;
@@ -1205,7 +1217,8 @@ ARMul_CheckWatch (ARMul_State * state, ARMword addr, int access)
 	    continue;
 	  }
 	/* found a match */
-	TracePrint ((state, "Watchpoint at %.8lx accessed\n", addr));
+	TracePrint ((state, "Watchpoint at %.8lx accessed\n",
+		     (unsigned long) addr));
 	state->EndCondition = RDIError_WatchpointAccessed;
 	state->Emulate = STOP;
 	state->StopHandle = (ARMword) p;
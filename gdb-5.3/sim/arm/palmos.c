@@ -0,0 +1,213 @@
+/*  palmos.c -- Running Palm OS armlets on the ARMulator.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA. */
+
+/* An armlet is not a program but an `armc' or `ARMC' code resource within
+   a .prc database, which PACE enters via PceNativeCall() as
+
+	unsigned long NativeFunc (const void *emulStateP, void *userData68KP,
+				  Call68KFuncType *call68KFuncP);
+
+   with r9 reserved for the system's globals.  To run one, we load the
+   resource from the database (as read by the prc-littlearm bfd backend),
+   build just enough of that environment to call it, and stop when it
+   returns, with its result as the exit status.  Calls back into 68K code
+   via call68KFunc land in a SWI handled here on the host.
+
+   The armlet may also use the Demon SWIs (SWI_Write0 and friends) to
+   produce output, as there is no Palm OS underneath it to do so.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bfd.h>
+#include "armdefs.h"
+#include "armemu.h"
+#include "palmos.h"
+#include "ansidecl.h"
+#include "gdb/callback.h"
+
+extern host_callback *sim_callback;
+
+int ARMul_PalmOSTrace;
+
+static unsigned long call68k_traps[kPceNativeTrapNoMask + 1];
+static unsigned long call68k_functions;
+
+/* Returns non-zero if ABFD is a Palm OS resource database.  */
+
+int
+ARMul_PalmOSPRCp (bfd *abfd)
+{
+  return abfd != NULL
+    && bfd_get_flavour (abfd) == bfd_target_unknown_flavour
+    && strncmp (bfd_get_target (abfd), "prc-", 4) == 0;
+}
+
+static void
+zero_block (ARMul_State * state, ARMword address, ARMword size)
+{
+  ARMword i;
+
+  for (i = 0; i < size; i += 4)
+    ARMul_WriteWord (state, address + i, 0);
+}
+
+/* Loads the first armc or ARMC resource in ABFD at PALMOS_CODE.  */
+
+int
+ARMul_PalmOSLoad (ARMul_State * state, bfd *abfd)
+{
+  asection *sec;
+
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if (strncmp (sec->name, "armc.", 5) == 0
+	|| strncmp (sec->name, "ARMC.", 5) == 0)
+      break;
+
+  if (sec == NULL)
+    {
+      sim_callback->printf_filtered
+	(sim_callback, "%s: no armc or ARMC resource\n",
+	 bfd_get_filename (abfd));
+      return FALSE;
+    }
+
+  {
+    bfd_size_type size = bfd_section_size (abfd, sec);
+    bfd_byte *buffer = (bfd_byte *) malloc (size);
+    bfd_size_type i;
+
+    if (buffer == NULL)
+      return FALSE;
+
+    if (! bfd_get_section_contents (abfd, sec, buffer, 0, size))
+      {
+	sim_callback->printf_filtered
+	  (sim_callback, "%s: can't read resource %s: %s\n",
+	   bfd_get_filename (abfd), sec->name, bfd_errmsg (bfd_get_error ()));
+	free (buffer);
+	return FALSE;
+      }
+
+    if (PALMOS_CODE + size > PALMOS_GLOBALS)
+      {
+	sim_callback->printf_filtered
+	  (sim_callback, "%s: resource %s is too large\n",
+	   bfd_get_filename (abfd), sec->name);
+	free (buffer);
+	return FALSE;
+      }
+
+    for (i = 0; i < size; i++)
+      ARMul_SafeWriteByte (state, PALMOS_CODE + i, buffer[i]);
+
+    free (buffer);
+
+    if (state->verbose)
+      sim_callback->printf_filtered
+	(sim_callback, "Loaded %s (%lu bytes) at 0x%lx\n",
+	 sec->name, (unsigned long) size, PALMOS_CODE);
+  }
+
+  return TRUE;
+}
+
+/* Sets up the registers and memory for PceNativeCall()'s call into the
+   armlet: the arguments in r0-r2, the system globals in r9, and a return
+   address that exits the simulator with the armlet's result.  */
+
+void
+ARMul_PalmOSSetupCall (ARMul_State * state)
+{
+  /* call68KFunc:  swi SWI_PalmOS_Call68K; bx lr.  */
+  ARMul_WriteWord (state, PALMOS_STUBS, 0xef000000 | SWI_PalmOS_Call68K);
+  ARMul_WriteWord (state, PALMOS_STUBS + 4, 0xe12fff1e);
+  /* Return address:  swi SWI_Exit.  */
+  ARMul_WriteWord (state, PALMOS_STUBS + 8, 0xef000011);
+
+  zero_block (state, PALMOS_GLOBALS, PALMOS_GLOBALS_SIZE);
+  zero_block (state, PALMOS_EMULSTATE, PALMOS_EMULSTATE_SIZE);
+  zero_block (state, PALMOS_USERDATA, PALMOS_USERDATA_SIZE);
+
+  memset (call68k_traps, 0, sizeof call68k_traps);
+  call68k_functions = 0;
+
+  state->Reg[0] = PALMOS_EMULSTATE;
+  state->Reg[1] = PALMOS_USERDATA;
+  state->Reg[2] = PALMOS_STUBS;
+  state->Reg[9] = PALMOS_GLOBALS;
+  state->Reg[13] = PALMOS_STACK;
+  state->Reg[14] = PALMOS_STUBS + 8;
+  ARMul_SetPC (state, PALMOS_CODE);
+}
+
+/* The host side of call68KFunc (emulStateP, trapOrFunction, argsOnStackP,
+   argsSizeAndwantA0).  There is no 68K code to run, so the call is
+   counted, logged if requested, and returns 0.  */
+
+void
+ARMul_PalmOSCall68K (ARMul_State * state)
+{
+  ARMword target = state->Reg[1];
+  ARMword flags = state->Reg[3];
+
+  if (target <= kPceNativeTrapNoMask)
+    call68k_traps[target]++;
+  else
+    call68k_functions++;
+
+  if (ARMul_PalmOSTrace)
+    {
+      if (target <= kPceNativeTrapNoMask)
+	fprintf (stderr, "call68KFunc: trap 0x%04lx",
+		 (unsigned long) (0xa000 | target));
+      else
+	fprintf (stderr, "call68KFunc: function 0x%08lx",
+		 (unsigned long) target);
+
+      fprintf (stderr, ", %lu bytes of arguments at 0x%08lx%s\n",
+	       (unsigned long) (flags & ~kPceNativeWantA0),
+	       (unsigned long) state->Reg[2],
+	       (flags & kPceNativeWantA0)? ", wants A0" : "");
+    }
+
+  state->Reg[0] = 0;
+}
+
+/* Reports the calls made through call68KFunc.  */
+
+void
+ARMul_PalmOSInfo (ARMul_State * state ATTRIBUTE_UNUSED)
+{
+  unsigned long total = call68k_functions;
+  int i;
+
+  for (i = 0; i <= kPceNativeTrapNoMask; i++)
+    total += call68k_traps[i];
+
+  sim_callback->printf_filtered
+    (sim_callback, "call68KFunc calls:        %10lu\n", total);
+
+  for (i = 0; i <= kPceNativeTrapNoMask; i++)
+    if (call68k_traps[i])
+      sim_callback->printf_filtered
+	(sim_callback, "  trap 0x%04x:            %10lu\n",
+	 0xa000 | i, call68k_traps[i]);
+
+  if (call68k_functions)
+    sim_callback->printf_filtered
+      (sim_callback, "  68K functions:          %10lu\n", call68k_functions);
+}
@@ -0,0 +1,50 @@
+/*  palmos.h -- Running Palm OS armlets on the ARMulator.
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA. */
+
+/* Memory layout used when running an armlet.  Everything fits within the
+   default 8 megabytes of simulated memory.  */
+
+#define PALMOS_STUBS		0x10000L	/* call68KFunc shim, return stub.  */
+#define PALMOS_CODE		0x100000L	/* The armc/ARMC resource.  */
+#define PALMOS_GLOBALS		0x700000L	/* r9 points here.  */
+#define PALMOS_GLOBALS_SIZE	0x10000L
+#define PALMOS_EMULSTATE	0x710000L	/* First argument (r0).  */
+#define PALMOS_EMULSTATE_SIZE	0x1000L
+#define PALMOS_USERDATA		0x711000L	/* Second argument (r1).  */
+#define PALMOS_USERDATA_SIZE	0x10000L
+#define PALMOS_STACK		0x800000L	/* Initial sp (full descending).  */
+
+/* The shim that call68KFunc points at executes this SWI; its number
+   spells "PNO".  */
+
+#define SWI_PalmOS_Call68K	0x504e4f
+
+/* PceNativeCall.h's encoding of call68KFunc's arguments.  */
+
+#define kPceNativeWantA0	0x10000000L
+#define kPceNativeTrapNoMask	0x00000fffL
+
+/* Non-zero to log each call68KFunc call on stderr.  */
+
+extern int ARMul_PalmOSTrace;
+
+struct _bfd;
+
+extern int      ARMul_PalmOSPRCp      (struct _bfd *);
+extern int      ARMul_PalmOSLoad      (ARMul_State *, struct _bfd *);
+extern void     ARMul_PalmOSSetupCall (ARMul_State *);
+extern void     ARMul_PalmOSCall68K   (ARMul_State *);
+extern void     ARMul_PalmOSInfo      (ARMul_State *);
@@ -33,7 +33,9 @@
 #include "armdefs.h"
 #include "armemu.h"
 #include "dbg_rdi.h"
+#include "palmos.h"
 #include "ansidecl.h"
+#include "libiberty.h"
 #include "sim-utils.h"
 #include "run-sim.h"
 #include "gdb/sim-arm.h"
@@ -57,6 +59,9 @@ static int verbosity;
 /* Non-zero to set big endian mode.  */
 static int big_endian;
 
+/* Non-zero if the program is a Palm OS armlet rather than an executable.  */
+static int palmos_prc;
+
 int stop_simulator;
 
 static void
@@ -284,6 +289,10 @@ sim_create_inferior (sd, abfd, argv, env)
 	 executed in THUMB mode.  */
       ARMul_SetCPSR (state, SVC32MODE);
     }
+
+  /* An armlet has no startup code; call it as PceNativeCall() would.  */
+  if (ARMul_PalmOSPRCp (abfd))
+    ARMul_PalmOSSetupCall (state);
   
   if (argv != NULL)
     {
@@ -341,6 +350,21 @@ sim_info (sd, verbose)
      SIM_DESC sd ATTRIBUTE_UNUSED;
      int verbose ATTRIBUTE_UNUSED;
 {
+  if (state == NULL)
+    return;
+
+  (*sim_callback->printf_filtered)
+    (sim_callback, "Instructions executed:    %10lu\n", state->NumInstrs);
+  (*sim_callback->printf_filtered)
+    (sim_callback, "Cycles:                   %10lu\n",
+     (unsigned long) ARMul_Time (state));
+  (*sim_callback->printf_filtered)
+    (sim_callback, "  S/N/I/C/F cycles:       %lu/%lu/%lu/%lu/%lu\n",
+     state->NumScycles, state->NumNcycles, state->NumIcycles,
+     state->NumCcycles, state->NumFcycles);
+
+  if (palmos_prc)
+    ARMul_PalmOSInfo (state);
 }
 
 static int
@@ -504,6 +528,7 @@ typedef struct
 } swi_options;
 
 #define SWI_SWITCH	"--swi-support"
+#define CALL68K_SWITCH	"--trace-call68k"
 
 static swi_options options[] =
   {
@@ -535,6 +560,18 @@ sim_target_parse_command_line (argc, argv)
       if ((ptr == NULL) || (* ptr != '-'))
 	break;
 
+      if (strcmp (ptr, CALL68K_SWITCH) == 0)
+	{
+	  ARMul_PalmOSTrace = 1;
+
+	  /* Remove this option from the argv array.  */
+	  for (arg = i; arg < argc; arg ++)
+	    argv[arg] = argv[arg + 1];
+	  argc --;
+	  i --;
+	  continue;
+	}
+
       if (strncmp (ptr, SWI_SWITCH, sizeof SWI_SWITCH - 1) != 0)
 	continue;
 
@@ -603,6 +640,8 @@ sim_target_display_usage ()
   fprintf (stderr, "%s=<list>  Comma seperated list of SWI protocols to supoport.\n\
                 This list can contain: NONE, DEMON, ANGEL, REDBOOT and/or ALL.\n",
 	   SWI_SWITCH);
+  fprintf (stderr, "%s  Log each call68KFunc call made by a Palm OS armlet.\n",
+	   CALL68K_SWITCH);
 }
 #endif
 
@@ -691,6 +730,13 @@ sim_load (sd, prog, abfd, from_tty)
 {
   bfd *prog_bfd;
 
+  palmos_prc = ARMul_PalmOSPRCp (abfd);
+  if (palmos_prc)
+    {
+      init ();
+      return ARMul_PalmOSLoad (state, abfd) ? SIM_RC_OK : SIM_RC_FAIL;
+    }
+
   prog_bfd = sim_load_file (sd, myname, sim_callback, prog, abfd,
 			    sim_kind == SIM_OPEN_DEBUG, 0, sim_write);
   if (prog_bfd == NULL)
@@ -47,6 +47,7 @@ typedef struct {
 
 Err SysAppStartup (SysAppInfoType**, void**, void**)  TRAP (0xA08F);
 Err SysAppExit (SysAppInfoType*, void*, void*)  TRAP (0xA090);
+void* SysGetTrapAddress (UInt16)  TRAP (0xA346);
 
 extern UInt32 PilotMain (Int16, void*, UInt16);
 
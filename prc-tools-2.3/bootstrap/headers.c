@@ -206,6 +206,7 @@ bootstrap (const char *fname) {
 
   trap_declare3 ("e", SysAppStartup, "<SysAppInfoType>**,v**,v**");
   trap_declare3 ("e", SysAppExit, "<SysAppInfoType>*,v*,v*");
+  trap_declare3 ("v*", SysGetTrapAddress, "u16");
   nl ();
 
   declare3 ("xu32", PilotMain, "16,v*,u16");
@@ -5,8 +5,13 @@ extern void __do_dtors (void);
 
 extern void _GccRelocateData (void);
 extern void _RelocateChain (Int16 offset, void *base);
+extern void _RelocateCode (UInt16 resno, void *const *text_bases);
+
+extern void _GccResolveDirectTraps (void);
 
 extern char data_start;
 extern char bss_start;
+extern char dtraps_start;
+extern char dtraps_end;
 
 #define UNUSED_PARAM  __attribute__ ((unused))
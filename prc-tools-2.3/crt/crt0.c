@@ -59,7 +59,10 @@ start ()
 #endif
 
       if (mainFlags & sysAppLaunchFlagNewGlobals)
-	_GccRelocateData ();
+	{
+	  _GccRelocateData ();
+	  _GccResolveDirectTraps ();
+	}
 
       __do_bhook (mainCmd, mainPBP, mainFlags);
 
@@ -33,11 +33,15 @@ _GccRelocateData ()
     {
       Int16 *chain = MemHandleLock (relocH);
 
+      void *text_base = (void *) &start;
+
       _RelocateChain (*chain++, &data_start);
-      _RelocateChain (*chain++, (void *) &start);
+      _RelocateChain (*chain++, text_base);
 
       MemHandleUnlock (relocH);
       DmReleaseResource (relocH);
+
+      _RelocateCode (1, &text_base);
     }
 }
 
@@ -68,6 +72,9 @@ _GccLoadCodeAndRelocateData ()
 
       MemHandleUnlock (relocH);
       DmReleaseResource (relocH);
+
+      for (resno = 1; resno <= baselim - &__text__; resno++)
+	_RelocateCode (resno, &__text__);
     }
 }
 
@@ -114,3 +121,51 @@ _RelocateChain (Int16 offset, void *base)
 }
 
 #endif
+#ifdef Lcode_reloc
+
+struct code_reloc
+{
+  UInt16 offset;
+  UInt16 target;
+  UInt32 addend;
+};
+
+/* Code resources stay in the storage heap, so rather than being threaded
+   through the pointers themselves like the data's reloc chains, the
+   relocs for code #RESNO are listed in rloc #RESNO, and each pointer is
+   written with DmWrite.  Code #N's base is TEXT_BASES[N-1].  The pointers
+   only ever point into code (build-prc rejects pointers from code to the
+   data, whose address differs from one launch to the next), and one
+   already holding the right value from a previous launch is left alone,
+   so the code is written to only the first time it is relocated after
+   being moved.  */
+
+void
+_RelocateCode (UInt16 resno, void *const *text_bases)
+{
+  MemHandle relocH = DmGet1Resource ('rloc', resno);
+  MemHandle codeH = DmGet1Resource ('code', resno);
+  if (relocH && codeH)
+    {
+      struct code_reloc *rel = MemHandleLock (relocH);
+      struct code_reloc *rellim = rel + MemHandleSize (relocH) / sizeof *rel;
+      char *code = MemHandleLock (codeH);
+
+      for (; rel < rellim; rel++)
+	{
+	  UInt32 value = (UInt32) text_bases[rel->target - 1] + rel->addend;
+	  if (*(UInt32 *) (code + rel->offset) != value)
+	    DmWrite (code, rel->offset, &value, sizeof value);
+	}
+
+      MemHandleUnlock (codeH);
+      MemHandleUnlock (relocH);
+    }
+
+  if (codeH)
+    DmReleaseResource (codeH);
+  if (relocH)
+    DmReleaseResource (relocH);
+}
+
+#endif
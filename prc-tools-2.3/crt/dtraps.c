@@ -0,0 +1,34 @@
+/* dtraps.c: fill in the direct trap table used by -mdirect-traps code.
+
+   This code is in the public domain.  In particular, object code compiled
+   from this code may be freely linked into your programs.  */
+
+#ifdef BOOTSTRAP
+#include "bootstrap.h"
+#else
+#include <SystemMgr.h>
+#include "NewTypes.h"
+#endif
+
+#include "crt.h"
+
+/* GCC emits one of these into the `dtraps' section for each systrap called
+   via -mdirect-traps in a translation unit; the linker script gathers them
+   all between dtraps_start and dtraps_end.  Callers do a `jsr' through
+   PROC instead of executing `trap #15; dc.w VECTOR'.  */
+
+struct direct_trap
+{
+  UInt16 vector;
+  void *proc;
+};
+
+void
+_GccResolveDirectTraps ()
+{
+  struct direct_trap *dt = (struct direct_trap *) &dtraps_start;
+  struct direct_trap *end = (struct direct_trap *) &dtraps_end;
+
+  for (; dt < end; dt++)
+    dt->proc = SysGetTrapAddress (dt->vector);
+}
@@ -146,6 +146,7 @@ UInt32 start(UInt16 ref, struct LibRef *libref,
     DmReleaseResource(dataH);
     reg_a4 = libref->globals;
     _GccRelocateData();
+    _GccResolveDirectTraps();
     __do_ctors();
     AllocSaveTable();
     __do_bhook(0, NULL, 0);
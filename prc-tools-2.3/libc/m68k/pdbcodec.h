@@ -0,0 +1,58 @@
+/* m68k/pdbcodec.h: expand records compressed by pdb-tool.
+
+   This file is part of prc-tools, but is not licensed in the same way
+   as the majority of prc-tools.  The contents of this file are in the
+   public domain.  */
+
+#ifndef _PRC_TOOLS_PDBCODEC_H
+#define _PRC_TOOLS_PDBCODEC_H
+
+#include <DataMgr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A database built by "pdb-tool import --compress" has this header and a
+   dictionary, trained on its records, as its AppInfo block.  Each record
+   is a big-endian 16-bit original length followed by tokens:  a control
+   byte C less than 0x80 is followed by C+1 literal bytes, while C >= 0x80
+   is followed by a big-endian 16-bit distance D and stands for the
+   (C & 0x7f) + 4 bytes starting D bytes back in the dictionary followed by
+   the record as expanded so far.  */
+
+#define PDB_CODEC_SIGNATURE  0x6c7a6463UL  /* 'lzdc' */
+#define PDB_CODEC_VERSION    1
+
+struct pdb_codec_info {
+  UInt32 signature;
+  UInt16 version;
+  UInt16 dictlen;
+  UInt8 dict[0];
+  };
+
+/* Returns the database's codec information, locked, or NULL if its records
+   are not compressed.  Unlock it with pdb_codec_unlock() when finished.  */
+
+const struct pdb_codec_info *pdb_codec_lock (DmOpenRef db);
+void pdb_codec_unlock (const struct pdb_codec_info *info);
+
+/* Returns the expanded length of the compressed record REC.  */
+
+UInt16 pdb_decompressed_size (const void *rec);
+
+/* Expands the RECLEN-byte compressed record REC into BUF, which has room
+   for BUFSIZE bytes, using the DICTLEN-byte dictionary DICT.  Returns the
+   expanded length, or -1 if the record is corrupt or BUF is too small.
+   This uses no dynamic memory and only a few words of stack, and makes no
+   system calls, so it can also be compiled for and tested on the host.  */
+
+Int32 pdb_decompress (const UInt8 *dict, UInt16 dictlen,
+		      const void *rec, UInt32 reclen,
+		      void *buf, UInt32 bufsize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
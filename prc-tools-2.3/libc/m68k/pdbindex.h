@@ -0,0 +1,103 @@
+/* m68k/pdbindex.h: look up records in a database sorted by pdb-tool.
+
+   This file is part of prc-tools, but is not licensed in the same way
+   as the majority of prc-tools.  The contents of this file are in the
+   public domain.  */
+
+#ifndef _PRC_TOOLS_PDBINDEX_H
+#define _PRC_TOOLS_PDBINDEX_H
+
+#include <DataMgr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A database built by "pdb-tool import --sort-key KEY --key-index" has its
+   records sorted by KEY and this index as its SortInfo block.  The index
+   holds the first WIDTH bytes (zero-padded) of the key of every INTERVAL'th
+   record, so a lookup can narrow its search to a few records without
+   touching any of them.  Keys compare as unsigned byte strings.  */
+
+#define PDB_KEY_INDEX_SIGNATURE  0x6b696478UL  /* 'kidx' */
+#define PDB_KEY_INDEX_VERSION	 1
+
+enum pdb_key_kind {
+  PDB_KEY_BYTES,	/* LENGTH bytes at offset PARAM  */
+  PDB_KEY_STRING,	/* The NUL-terminated string at offset PARAM  */
+  PDB_KEY_FIELD		/* The PARAM'th NUL-terminated string  */
+  };
+
+struct pdb_key_index {
+  UInt32 signature;
+  UInt16 version;
+  UInt16 kind, param, length;
+  UInt16 width, interval, entries, records;
+  UInt8 keys[0];
+  };
+
+/* Returns the database's key index, locked, or NULL if it doesn't have
+   one.  Unlock it with pdb_key_index_unlock() when you are finished.  */
+
+const struct pdb_key_index *pdb_key_index_lock (DmOpenRef db);
+void pdb_key_index_unlock (const struct pdb_key_index *index);
+
+/* Returns the position of the first record whose key is not less than
+   the KEYLEN bytes at KEY, or the number of records if there is none,
+   and sets *FOUNDP (if non-NULL) to whether that record's key is equal.
+   Each record examined is locked just once.  If records have been added
+   or deleted since INDEX was built, the whole database is searched, which
+   still works as long as the records have been kept in order.  */
+
+UInt16 pdb_key_index_find (DmOpenRef db, const struct pdb_key_index *index,
+			   const void *key, UInt16 keylen, Boolean *foundP);
+
+
+/* A collection of records too large for one database is written by
+   pdb-tool as several shard databases, each with its own key index, and a
+   master database whose AppInfo block is a pdb_shard_info and whose records
+   are pdb_shard entries, one for each shard in order.  KIND is
+   PDB_KEY_NONE if the records were not sorted.  */
+
+#define PDB_SHARD_INFO_SIGNATURE  0x73687264UL  /* 'shrd' */
+#define PDB_SHARD_INFO_VERSION	  1
+#define PDB_KEY_NONE		  0xffff
+
+struct pdb_shard_info {
+  UInt32 signature;
+  UInt16 version;
+  UInt16 shards;
+  UInt32 records;
+  UInt16 kind, param, length;
+  UInt16 reserved;
+  };
+
+struct pdb_shard {
+  UInt32 first;		/* Overall number of the shard's first record  */
+  UInt16 count;
+  UInt16 keylen, lastkeylen;
+  Char name[32];
+  UInt8 key[0];		/* The shard's first key, followed by its last  */
+  };
+
+/* Opens (with DmOpenDatabase MODE) the shard that contains the first record
+   whose key is not less than the KEYLEN bytes at KEY, and sets *RECNOP to
+   its position within the shard and *FOUNDP (if non-NULL) to whether its
+   key is equal.  If there is no such record, opens the last shard, and
+   sets *RECNOP to its number of records.  Only one shard is opened;
+   close it with DmCloseDatabase.  Returns NULL on failure.  */
+
+DmOpenRef pdb_shard_find (DmOpenRef master, const void *key, UInt16 keylen,
+			  UInt16 mode, UInt16 *recnoP, Boolean *foundP);
+
+/* Opens the shard containing the overall record number RECNO, and sets
+   *LOCALP to its position within the shard.  */
+
+DmOpenRef pdb_shard_open_record (DmOpenRef master, UInt32 recno,
+				 UInt16 mode, UInt16 *localP);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
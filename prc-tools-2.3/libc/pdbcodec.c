@@ -0,0 +1,73 @@
+/* Expansion of records compressed by pdb-tool.
+
+   This code is in the public domain.  */
+
+#include <DataMgr.h>
+
+#include "m68k/pdbcodec.h"
+
+UInt16
+pdb_decompressed_size (const void *rec) {
+  const UInt8 *s = rec;
+  return (s[0] << 8) | s[1];
+  }
+
+Int32
+pdb_decompress (const UInt8 *dict, UInt16 dictlen,
+		const void *rec, UInt32 reclen, void *buf, UInt32 bufsize) {
+  const UInt8 *s = rec;
+  const UInt8 *lim = s + reclen;
+  UInt8 *out = buf;
+  UInt8 *outlim;
+  UInt32 len;
+
+  if (reclen < 2)
+    return -1;
+
+  len = (s[0] << 8) | s[1];
+  s += 2;
+  if (len > bufsize)
+    return -1;
+  outlim = out + len;
+
+  while (s < lim) {
+    UInt16 c = *s++;
+
+    if (c < 0x80) {
+      UInt16 n = c + 1;
+      if (n > lim - s || n > outlim - out)
+	return -1;
+      while (n-- > 0)
+	*out++ = *s++;
+      }
+    else {
+      UInt16 n = (c & 0x7f) + 4;
+      UInt32 dist, pos;
+      const UInt8 *from;
+
+      if (lim - s < 2)
+	return -1;
+      dist = (s[0] << 8) | s[1];
+      s += 2;
+
+      pos = out - (UInt8 *) buf;
+      if (dist == 0 || dist > pos + dictlen || n > outlim - out)
+	return -1;
+
+      /* The first part of the match may come from the dictionary.  */
+      if (dist > pos) {
+	from = dict + dictlen - (dist - pos);
+	while (n > 0 && from < dict + dictlen)
+	  *out++ = *from++, n--;
+	}
+
+      /* The copy must go forwards byte by byte, as the match may overlap
+	 the bytes it is producing.  */
+      from = out - dist;
+      while (n-- > 0)
+	*out++ = *from++;
+      }
+    }
+
+  return (out == outlim)? (Int32) len : -1;
+  }
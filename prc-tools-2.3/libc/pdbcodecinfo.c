@@ -0,0 +1,40 @@
+/* Access to the dictionary of a database compressed by pdb-tool.
+
+   This code is in the public domain.  */
+
+#include <DataMgr.h>
+#include <MemoryMgr.h>
+
+#include "m68k/pdbcodec.h"
+
+const struct pdb_codec_info *
+pdb_codec_lock (DmOpenRef db) {
+  LocalID dbID, appInfoID;
+  UInt16 cardNo;
+  const struct pdb_codec_info *info;
+
+  if (DmOpenDatabaseInfo (db, &dbID, NULL, NULL, &cardNo, NULL) != 0
+      || DmDatabaseInfo (cardNo, dbID, NULL, NULL, NULL, NULL, NULL, NULL,
+			 NULL, &appInfoID, NULL, NULL, NULL) != 0
+      || appInfoID == 0)
+    return NULL;
+
+  info = MemLocalIDToLockedPtr (appInfoID, cardNo);
+  if (info == NULL)
+    return NULL;
+
+  if (MemPtrSize ((void *) info) < sizeof *info
+      || info->signature != PDB_CODEC_SIGNATURE
+      || info->version != PDB_CODEC_VERSION
+      || MemPtrSize ((void *) info) < sizeof *info + info->dictlen) {
+    MemPtrUnlock ((void *) info);
+    return NULL;
+    }
+
+  return info;
+  }
+
+void
+pdb_codec_unlock (const struct pdb_codec_info *info) {
+  if (info)  MemPtrUnlock ((void *) info);
+  }
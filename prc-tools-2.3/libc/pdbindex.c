@@ -0,0 +1,182 @@
+/* Record lookup via the key index built by pdb-tool.
+
+   This code is in the public domain.  */
+
+#include <DataMgr.h>
+#include <MemoryMgr.h>
+#include "NewTypes.h"
+
+#include "m68k/pdbindex.h"
+
+const struct pdb_key_index *
+pdb_key_index_lock (DmOpenRef db) {
+  LocalID dbID, sortInfoID;
+  UInt16 cardNo;
+  const struct pdb_key_index *index;
+
+  if (DmOpenDatabaseInfo (db, &dbID, NULL, NULL, &cardNo, NULL) != 0
+      || DmDatabaseInfo (cardNo, dbID, NULL, NULL, NULL, NULL, NULL, NULL,
+			 NULL, NULL, &sortInfoID, NULL, NULL) != 0
+      || sortInfoID == 0)
+    return NULL;
+
+  index = MemLocalIDToLockedPtr (sortInfoID, cardNo);
+  if (index == NULL)
+    return NULL;
+
+  if (MemPtrSize ((void *) index) < sizeof *index
+      || index->signature != PDB_KEY_INDEX_SIGNATURE
+      || index->version != PDB_KEY_INDEX_VERSION
+      || MemPtrSize ((void *) index)
+	   < sizeof *index + (UInt32) index->entries * index->width) {
+    MemPtrUnlock ((void *) index);
+    return NULL;
+    }
+
+  return index;
+  }
+
+void
+pdb_key_index_unlock (const struct pdb_key_index *index) {
+  if (index)  MemPtrUnlock ((void *) index);
+  }
+
+static Int16
+compare_keys (const UInt8 *a, UInt16 alen, const UInt8 *b, UInt16 blen) {
+  UInt16 len = (alen < blen)? alen : blen;
+  UInt16 i;
+
+  for (i = 0; i < len; i++)
+    if (a[i] != b[i])
+      return (a[i] < b[i])? -1 : 1;
+
+  return (alen < blen)? -1 : (alen > blen)? 1 : 0;
+  }
+
+/* Compares the index entry PREFIX with the first WIDTH bytes of KEY,
+   zero-padded.  */
+
+static Int16
+compare_prefix (const UInt8 *prefix, UInt16 width,
+		const UInt8 *key, UInt16 keylen) {
+  UInt16 i;
+
+  for (i = 0; i < width; i++) {
+    UInt8 k = (i < keylen)? key[i] : 0;
+    if (prefix[i] != k)
+      return (prefix[i] < k)? -1 : 1;
+    }
+
+  return 0;
+  }
+
+static const UInt8 *
+find_nul (const UInt8 *s, const UInt8 *lim) {
+  while (s < lim && *s)
+    s++;
+  return s;
+  }
+
+/* Compares the key of record RECNO with the KEYLEN bytes at KEY.  */
+
+static Int16
+compare_record (DmOpenRef db, UInt16 recno, UInt16 kind, UInt16 param,
+		UInt16 length, const UInt8 *key, UInt16 keylen) {
+  MemHandle h = DmQueryRecord (db, recno);
+  const UInt8 *rec, *s, *lim;
+  UInt16 i;
+  Int16 cmp;
+
+  if (h == NULL)
+    return compare_keys (NULL, 0, key, keylen);
+
+  rec = MemHandleLock (h);
+  lim = rec + MemHandleSize (h);
+  s = (param < lim - rec)? rec + param : lim;
+
+  switch (kind) {
+  case PDB_KEY_BYTES:
+    /* Bytes past the end of the record count as zeroes.  */
+    for (cmp = 0, i = 0; cmp == 0 && i < length && i < keylen; i++) {
+      UInt8 b = (s + i < lim)? s[i] : 0;
+      if (b != key[i])
+	cmp = (b < key[i])? -1 : 1;
+      }
+    if (cmp == 0)
+      cmp = (length < keylen)? -1 : (length > keylen)? 1 : 0;
+    break;
+
+  case PDB_KEY_STRING:
+    cmp = compare_keys (s, find_nul (s, lim) - s, key, keylen);
+    break;
+
+  default:
+    for (s = rec, i = 0; i < param && s < lim; i++)
+      s = find_nul (s, lim) + 1;
+    if (s > lim)
+      s = lim;
+    cmp = compare_keys (s, find_nul (s, lim) - s, key, keylen);
+    break;
+    }
+
+  MemHandleUnlock (h);
+  return cmp;
+  }
+
+UInt16
+pdb_key_index_find (DmOpenRef db, const struct pdb_key_index *index,
+		    const void *keyP, UInt16 keylen, Boolean *foundP) {
+  const UInt8 *key = keyP;
+  UInt16 n = DmNumRecords (db);
+  UInt16 lo = 0, hi = n, equal_at = n;
+
+  if (index->records == n && index->interval > 0) {
+    /* Entries whose prefix is less than KEY's come from records known to
+       have lesser keys, and those whose prefix is greater from records
+       with greater keys; only between these must the records be read.  */
+    UInt16 elo = 0, ehi = index->entries, e, width = index->width;
+
+    while (elo < ehi) {
+      e = elo + (ehi - elo) / 2;
+      if (compare_prefix (&index->keys[(UInt32) e * width], width,
+			  key, keylen) < 0)
+	elo = e + 1;
+      else
+	ehi = e;
+      }
+
+    if (elo > 0)
+      lo = (elo - 1) * index->interval + 1;
+
+    ehi = index->entries;
+    while (elo < ehi) {
+      e = elo + (ehi - elo) / 2;
+      if (compare_prefix (&index->keys[(UInt32) e * width], width,
+			  key, keylen) <= 0)
+	elo = e + 1;
+      else
+	ehi = e;
+      }
+
+    if (elo < index->entries)
+      hi = elo * index->interval;
+    }
+
+  while (lo < hi) {
+    UInt16 mid = lo + (hi - lo) / 2;
+    Int16 cmp = compare_record (db, mid, index->kind, index->param,
+				index->length, key, keylen);
+
+    if (cmp < 0)
+      lo = mid + 1;
+    else {
+      hi = mid;
+      if (cmp == 0)  equal_at = mid;
+      }
+    }
+
+  if (foundP)
+    *foundP = (lo < n && lo == equal_at);
+
+  return lo;
+  }
@@ -0,0 +1,154 @@
+/* Opening the right shard of a collection split up by pdb-tool.
+
+   This code is in the public domain.  */
+
+#include <DataMgr.h>
+#include <MemoryMgr.h>
+#include "NewTypes.h"
+
+#include "m68k/pdbindex.h"
+
+/* Compares the first (or, if LAST, the last) key of shard SHARD with the
+   KEYLEN bytes at KEY.  */
+
+static Int16
+compare_shard_key (DmOpenRef master, UInt16 shard, Boolean last,
+		   const UInt8 *key, UInt16 keylen) {
+  MemHandle h = DmQueryRecord (master, shard);
+  const struct pdb_shard *sh;
+  const UInt8 *shkey;
+  UInt16 shkeylen, len, i;
+  Int16 cmp = 0;
+
+  if (h == NULL)
+    return -1;
+
+  sh = MemHandleLock (h);
+  shkey = (last)? &sh->key[sh->keylen] : sh->key;
+  shkeylen = (last)? sh->lastkeylen : sh->keylen;
+  len = (shkeylen < keylen)? shkeylen : keylen;
+  for (i = 0; cmp == 0 && i < len; i++)
+    if (shkey[i] != key[i])
+      cmp = (shkey[i] < key[i])? -1 : 1;
+  if (cmp == 0)
+    cmp = (shkeylen < keylen)? -1 : (shkeylen > keylen)? 1 : 0;
+  MemHandleUnlock (h);
+
+  return cmp;
+  }
+
+static DmOpenRef
+open_shard (DmOpenRef master, UInt16 shard, UInt16 mode) {
+  LocalID dbID;
+  UInt16 cardNo;
+  MemHandle h = DmQueryRecord (master, shard);
+  const struct pdb_shard *sh;
+  DmOpenRef db = NULL;
+
+  if (h == NULL
+      || DmOpenDatabaseInfo (master, &dbID, NULL, NULL, &cardNo, NULL) != 0)
+    return NULL;
+
+  sh = MemHandleLock (h);
+  dbID = DmFindDatabase (cardNo, sh->name);
+  if (dbID)
+    db = DmOpenDatabase (cardNo, dbID, mode);
+  MemHandleUnlock (h);
+
+  return db;
+  }
+
+DmOpenRef
+pdb_shard_find (DmOpenRef master, const void *keyP, UInt16 keylen,
+		UInt16 mode, UInt16 *recnoP, Boolean *foundP) {
+  const UInt8 *key = keyP;
+  UInt16 nshards = DmNumRecords (master);
+  UInt16 lo = 0, hi = nshards;
+  const struct pdb_key_index *index;
+  DmOpenRef db;
+  Boolean found;
+
+  if (nshards == 0)
+    return NULL;
+
+  /* Count the shards whose first key is less than KEY.  The record sought
+     is in the last of these, unless all of that shard's keys are less than
+     KEY, in which case it is the first record of the next shard.  */
+  while (lo < hi) {
+    UInt16 mid = lo + (hi - lo) / 2;
+    if (compare_shard_key (master, mid, false, key, keylen) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+    }
+
+  if (lo > 0
+      && (lo == nshards
+	  || compare_shard_key (master, lo - 1, true, key, keylen) >= 0))
+    lo--;
+  else {
+    db = open_shard (master, lo, mode);
+    *recnoP = 0;
+    if (foundP)
+      *foundP = (compare_shard_key (master, lo, false, key, keylen) == 0);
+    return db;
+    }
+
+  db = open_shard (master, lo, mode);
+  if (db == NULL)
+    return NULL;
+
+  index = pdb_key_index_lock (db);
+  if (index == NULL) {
+    DmCloseDatabase (db);
+    return NULL;
+    }
+
+  *recnoP = pdb_key_index_find (db, index, key, keylen, &found);
+  pdb_key_index_unlock (index);
+
+  if (foundP)
+    *foundP = found;
+
+  return db;
+  }
+
+DmOpenRef
+pdb_shard_open_record (DmOpenRef master, UInt32 recno,
+		       UInt16 mode, UInt16 *localP) {
+  UInt16 lo = 0, hi = DmNumRecords (master);
+  DmOpenRef db;
+  UInt32 first = 0;
+
+  /* Find the last shard whose first record is not after RECNO.  */
+  while (hi - lo > 1) {
+    UInt16 mid = lo + (hi - lo) / 2;
+    MemHandle h = DmQueryRecord (master, mid);
+    const struct pdb_shard *sh;
+
+    if (h == NULL)
+      return NULL;
+
+    sh = MemHandleLock (h);
+    if (sh->first <= recno)
+      lo = mid;
+    else
+      hi = mid;
+    MemHandleUnlock (h);
+    }
+
+  if (lo < hi) {
+    MemHandle h = DmQueryRecord (master, lo);
+    if (h) {
+      const struct pdb_shard *sh = MemHandleLock (h);
+      first = sh->first;
+      MemHandleUnlock (h);
+      }
+    }
+
+  db = open_shard (master, lo, mode);
+  if (db && localP)
+    *localP = recno - first;
+
+  return db;
+  }
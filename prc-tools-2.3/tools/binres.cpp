@@ -29,6 +29,8 @@
 
 #include "binres.hpp"
 
+#include <vector>
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -56,6 +58,22 @@
 #define RELOC_SIZE 4
 #endif
 
+#if 0
+#include "elf-bfd.h"
+#else
+/* Similarly, all we need from elf-bfd.h is the start of elf_symbol_type,
+   so that we can see a symbol's ELF type (and thus tell Thumb functions
+   from ARM ones), just as the ARM disassembler does.  */
+#include "elf/common.h"
+#include "elf/internal.h"
+#include "elf/arm.h"
+
+typedef struct {
+  asymbol symbol;
+  Elf_Internal_Sym internal_elf_sym;
+  } elf_symbol_type;
+#endif
+
 
 /* Use this instead of using bfd_get_section_contents directly, so that we
    can report read errors just once, here, instead of in every caller.  */
@@ -108,30 +126,74 @@ make_main_code_m68k (Datablock& res, const char* fname, unsigned long entry) {
   return res;
   }
 
+static inline void
+put_arm_long (unsigned char*& s, unsigned long v) {
+  *s++ = v, *s++ = v >> 8, *s++ = v >> 16, *s++ = v >> 24;
+  }
+
+/* PACE always calls an armlet in ARM state, so if the entry point is a
+   Thumb function the jump to it must also switch state.  */
+
 static Datablock
-make_main_code_arm (Datablock& res, const char* fname, unsigned long entry) {
+make_main_code_arm (Datablock& res, const char* fname, unsigned long entry,
+		    bool thumb) {
   if (entry > 33554432)
     error ("[%s] entry point 0x%lx too distant", fname, entry);
+  else if (thumb && entry < 255) {
+    res = res (-8, res.size () + 8);
+    unsigned char* s = res.writable_contents ();
+    put_arm_long (s, 0xe28fc000 | (entry + 1));	// add ip, pc, #OFF+1
+    put_arm_long (s, 0xe12fff1c);		// bx ip
+    }
+  else if (thumb) {
+    res = res (-16, res.size () + 16);
+    unsigned char* s = res.writable_contents ();
+    put_arm_long (s, 0xe59fc004);		// ldr ip, [pc, #4]
+    put_arm_long (s, 0xe08fc00c);		// add ip, pc, ip
+    put_arm_long (s, 0xe12fff1c);		// bx ip
+    put_arm_long (s, entry + 5);		// OFF+1 relative to the add
+    }
   else if (entry > 0) {
     res = res (-4, res.size () + 4);
     unsigned char* s = res.writable_contents ();
 
-    /* This is the first code that needs to write something ARM-endian!
-       FIXME Use some put_arm_word-style functions.  */
-
     // On ARM, a jump offset is measured in 32-bit words and is relative to the
     // instruction after next -- 0 corresponds to skipping one instruction.
-    entry = (entry - 4) >> 2;
-
-    put_byte (s, entry & 0xff);
-    put_byte (s, (entry >>  8) & 0xff);
-    put_byte (s, (entry >> 16) & 0xff);
-    put_byte (s, 0xea);		// b OFF
+    put_arm_long (s, 0xea000000 | ((entry - 4) >> 2));	// b OFF
     }
 
   return res;
   }
 
+/* Returns true if the entry point of ABFD is a Thumb function.  */
+
+static bool
+thumb_entry_p (bfd* abfd) {
+  if (bfd_get_flavour (abfd) != bfd_target_elf_flavour)
+    return false;
+
+  long symsize = bfd_get_symtab_upper_bound (abfd);
+  if (symsize <= 0)
+    return false;
+
+  asymbol** syms = static_cast<asymbol**>(xmalloc (symsize));
+  long nsyms = bfd_canonicalize_symtab (abfd, syms);
+  bfd_vma start = bfd_get_start_address (abfd);
+  bool thumb = false;
+
+  for (long i = 0; i < nsyms; i++)
+    if (bfd_asymbol_value (syms[i]) == start
+	&& ! (syms[i]->flags & BSF_SECTION_SYM)) {
+      const elf_symbol_type* sym =
+	  reinterpret_cast<const elf_symbol_type*>(syms[i]);
+      if (ELF_ST_TYPE (sym->internal_elf_sym.st_info) == STT_ARM_TFUNC)
+	thumb = true;
+      }
+
+  free (syms);
+  return thumb;
+  }
+
 static Datablock
 make_main_code (bfd* abfd, asection* sec) {
   Datablock res = make_code (abfd, sec);
@@ -141,7 +203,8 @@ make_main_code (bfd* abfd, asection* sec) {
 
   switch (bfd_get_arch (abfd)) {
   case bfd_arch_m68k:	return make_main_code_m68k (res, fname, entry);
-  case bfd_arch_arm:	return make_main_code_arm  (res, fname, entry);
+  case bfd_arch_arm:	return make_main_code_arm  (res, fname, entry,
+						    thumb_entry_p (abfd));
   default:		return res;
     }
   }
@@ -196,19 +259,160 @@ make_pref (unsigned long stack) {
   }
 
 
-/* The (new-style) rloc resource, which contains the head of a reloc chain
-   for each resource (data#0, code#1, code#2, ...).  As a by-product,
-   updates the (raw) DATA with the links of the reloc chains.  */
-
 /* There is an array of these, indexed by section index.  */
 struct resource_info {
   long chain;	/* Which chain to add relocs to (0 = data, -1 = unknown).  */
   long offset;	/* This section's offset within the resource it lies in.  */
   };
 
-static Datablock
-make_rloc_and_chains (int nchains, const resource_info* res_from_sec,
-		      bfd* abfd, asection* reloc_sec, bfd_size_type reloc_size,
+
+/* A relocation to be applied at run time: an absolute longword at OFFSET
+   within section RELSECNDX, which points into section SYMSECNDX.  These
+   come either from the .reloc section generated by ld --embedded-relocs,
+   or from the executable's own relocs if it was linked with --emit-relocs.
+   The latter cover the code sections as well as the data.  */
+
+struct runtime_reloc {
+  int relsecndx;
+  unsigned long offset;
+  int symsecndx;
+  };
+
+static const char*
+name_of_section_index (bfd* abfd, int ndx, char* buffer) {
+  for (asection* sec = abfd->sections; sec; sec = sec->next)
+    if (sec->index == ndx)
+      return bfd_section_name (abfd, sec);
+
+  sprintf (buffer, "[%d?]", ndx);
+  return buffer;
+  }
+
+static void
+read_embedded_relocs (bfd* abfd, asection* reloc_sec,
+		      std::vector<runtime_reloc>& relocs) {
+  bfd_size_type reloc_size = bfd_section_size (abfd, reloc_sec);
+  bfd_byte* reloc = static_cast<bfd_byte*>(xmalloc (reloc_size));
+  if (! get_section_contents (abfd, reloc_sec, reloc, 0, reloc_size))
+    reloc_size = 0;  // Short circuit the for loop
+
+  for (bfd_byte* rel = reloc; rel < reloc + reloc_size; rel += 12) {
+    runtime_reloc r;
+    unsigned int type = bfd_get_16 (abfd, rel);
+    r.relsecndx = bfd_get_16 (abfd, rel+2);
+    r.offset    = bfd_get_32 (abfd, rel+4);
+    r.symsecndx = bfd_get_16 (abfd, rel+8);
+
+    if (type == 1)  /* Absolute 32bit reference */
+      relocs.push_back (r);
+    else {
+      char buffer[32];
+      warning ("[%s:%s+0x%04lx] unknown reloc type 0x%x",
+	       bfd_get_filename (abfd),
+	       name_of_section_index (abfd, r.relsecndx, buffer),
+	       r.offset, type);
+      }
+    }
+
+  free (reloc);
+  }
+
+static void
+read_emitted_relocs (bfd* abfd, const resource_info* res_from_sec,
+		     std::vector<runtime_reloc>& relocs) {
+  long symsize = bfd_get_symtab_upper_bound (abfd);
+  asymbol** syms = (symsize > 0)? static_cast<asymbol**>(xmalloc (symsize))
+				: NULL;
+  if (symsize < 0 || (syms && bfd_canonicalize_symtab (abfd, syms) < 0)) {
+    error ("[%s] can't read symbols: %s", bfd_get_filename (abfd),
+	   bfd_errmsg (bfd_get_error ()));
+    free (syms);
+    return;
+    }
+
+  for (asection* sec = abfd->sections; sec; sec = sec->next) {
+    // Relocs in debugging sections and the like are of no interest.
+    if (! (bfd_get_section_flags (abfd, sec) & SEC_RELOC)
+	|| res_from_sec[sec->index].chain == -1)
+      continue;
+
+    long relsize = bfd_get_reloc_upper_bound (abfd, sec);
+    arelent** relpp = static_cast<arelent**>(xmalloc (relsize));
+    long relcount = bfd_canonicalize_reloc (abfd, sec, relpp, syms);
+    if (relcount < 0)
+      error ("[%s:%s] can't read relocs: %s", bfd_get_filename (abfd),
+	     bfd_section_name (abfd, sec), bfd_errmsg (bfd_get_error ()));
+
+    for (long i = 0; i < relcount; i++) {
+      const arelent* rel = relpp[i];
+      asection* symsec = (*rel->sym_ptr_ptr)->section;
+
+      /* PC-relative references don't change when the code moves, and nor
+	 do absolute values.  Most relocs in code sections are one or the
+	 other, or are 16-bit offsets from the globals pointer.  */
+      if (rel->howto == NULL || bfd_is_abs_section (symsec))
+	continue;
+
+      /* But a PC-relative reference (such as a call, or a -fvtable-relative
+	 vtable entry) is only right if both ends are in the same resource,
+	 as resources are placed independently.  */
+      if (rel->howto->pc_relative) {
+	if (! bfd_is_und_section (symsec)
+	    && res_from_sec[symsec->index].chain != -1
+	    && res_from_sec[symsec->index].chain
+		 != res_from_sec[sec->index].chain)
+	  warning ("[%s:%s+0x%04lx] PC-relative reference to section '%s', "
+		   "which is in a different resource",
+		   bfd_get_filename (abfd), bfd_section_name (abfd, sec),
+		   (unsigned long) rel->address,
+		   bfd_section_name (abfd, symsec));
+	continue;
+	}
+
+      if (rel->howto->size != 2 || rel->howto->bitsize != 32) {
+	if (res_from_sec[sec->index].chain == 0)
+	  warning ("[%s:%s+0x%04lx] unknown reloc type '%s'",
+		   bfd_get_filename (abfd), bfd_section_name (abfd, sec),
+		   (unsigned long) rel->address, rel->howto->name);
+	continue;
+	}
+
+      runtime_reloc r;
+      r.relsecndx = sec->index;
+      r.offset = rel->address;
+      r.symsecndx = bfd_is_und_section (symsec)? -1 : symsec->index;
+      relocs.push_back (r);
+      }
+
+    free (relpp);
+    }
+
+  free (syms);
+  }
+
+
+/* The (new-style) rloc resource, which contains the head of a reloc chain
+   for each resource (data#0, code#1, code#2, ...).  As a by-product,
+   updates the (raw) DATA with the links of the reloc chains.
+
+   Code resources can't hold reloc chains, as they are not copied into the
+   dynamic heap like the data is.  So the absolute pointers in code #N are
+   listed in an rloc #N resource instead, which the startup code uses to
+   patch code #N in place each time it is loaded.  Each entry is a word
+   giving the offset of the pointer in code #N, a word giving the code
+   resource M it points into, and the longword offset it points to within
+   code #M.
+
+   Pointers from code into the data are rejected: the globals are
+   allocated afresh for each launch (and for each sublaunch with new
+   globals, which shares the code), so such a pointer would have to be
+   rewritten every time and would be wrong for all but one instance.  */
+
+static void
+make_rloc_and_chains (ResourceDatabase& db, int nchains,
+		      const resource_info* res_from_sec,
+		      const std::map<long, ResKey>& code_from_chain,
+		      bfd* abfd, const std::vector<runtime_reloc>& relocs,
 		      bfd_byte* data, bfd_size_type data_size) {
   Datablock res (2 * nchains);
   unsigned char* rloc_res = res.writable_contents ();
@@ -217,26 +421,17 @@ make_rloc_and_chains (int nchains, const resource_info* res_from_sec,
   for (int i = 0; i < nchains; i++)
     put_word (s, 0xffff);
 
-  bfd_byte* reloc = NULL;
-  if (reloc_size > 0) {
-    reloc = static_cast<bfd_byte*>(xmalloc (reloc_size));
-    if (! get_section_contents (abfd, reloc_sec, reloc, 0, reloc_size))
-      reloc_size = 0;  // Short circuit the for loop
-    }
+  std::map<long, std::vector<unsigned char> > code_rlocs;
 
-  for (bfd_byte* rel = reloc; rel < reloc + reloc_size; rel += 12) {
-    unsigned int type;
-    unsigned long reloffset;
-    int relsecndx, symsecndx;
+  for (std::vector<runtime_reloc>::const_iterator it = relocs.begin();
+       it != relocs.end();
+       ++it) {
+    int relsecndx = (*it).relsecndx, symsecndx = (*it).symsecndx;
+    unsigned long reloffset = (*it).offset;
     asection *sec, *relsec, *symsec;
     CONST char *relsecname, *symsecname;
     char relbuffer[32], symbuffer[32];
 
-    type      = bfd_get_16 (abfd, rel);
-    relsecndx = bfd_get_16 (abfd, rel+2);
-    reloffset = bfd_get_32 (abfd, rel+4);
-    symsecndx = bfd_get_16 (abfd, rel+8);
-
     relsec = symsec = NULL;
     for (sec = abfd->sections; sec; sec = sec->next) {
       if (sec->index == relsecndx)  relsec = sec;
@@ -249,13 +444,20 @@ make_rloc_and_chains (int nchains, const resource_info* res_from_sec,
     sprintf (symbuffer, "[%d?]", (int) symsecndx);
     symsecname = (symsec)? bfd_section_name (abfd, symsec) : symbuffer;
 
-    if (!relsec || res_from_sec[relsecndx].chain != 0) {
+    std::map<long, ResKey>::const_iterator code = code_from_chain.end();
+    if (relsec && res_from_sec[relsecndx].chain > 0)
+      code = code_from_chain.find (res_from_sec[relsecndx].chain);
+
+    if (!relsec || (res_from_sec[relsecndx].chain != 0
+		    && code == code_from_chain.end())) {
       warning ("[%s:%s+0x%04lx] reloc in non-data section '%s'",
 	       bfd_get_filename (abfd), relsecname, reloffset, relsecname);
       continue;
       }
 
-    if (reloffset > data_size - RELOC_SIZE) {
+    bfd_size_type relsec_size = (code == code_from_chain.end())? data_size
+					: bfd_section_size (abfd, relsec);
+    if (reloffset > relsec_size - RELOC_SIZE) {
       warning ("[%s:%s+0x%04lx] reloc location out of range",
 	       bfd_get_filename (abfd), relsecname, reloffset);
       continue;
@@ -267,8 +469,7 @@ make_rloc_and_chains (int nchains, const resource_info* res_from_sec,
       continue;
       }
 
-    switch (type) {
-    case 1: {  /* Absolute 32bit reference */
+    if (code == code_from_chain.end()) {
       unsigned long value =
 	  (bfd_get_32 (abfd, data + reloffset) - bfd_section_vma (abfd, symsec)
 	   + res_from_sec[symsecndx].offset);
@@ -279,17 +480,49 @@ make_rloc_and_chains (int nchains, const resource_info* res_from_sec,
       bfd_put_16 (abfd, value, data+reloffset+2);
       put_word (reshead, reloffset);
       }
-      break;
-
-    default:
-      warning ("[%s:%s+0x%04lx] unknown reloc type 0x%x",
-	       bfd_get_filename (abfd), relsecname, reloffset, type);
+    else if (res_from_sec[symsecndx].chain == 0) {
+      error ("[%s:%s+0x%04lx] absolute reference from code to data "
+	     "section '%s'", bfd_get_filename (abfd), relsecname, reloffset,
+	     symsecname);
       continue;
       }
+    else {
+      /* The main code resource may have had a jump to the entry point
+	 inserted in front of the section's contents.  */
+      const Datablock& block = db[(*code).second];
+      unsigned long site =
+	  reloffset + (block.size () - bfd_section_size (abfd, relsec));
+      if (site > 0xffff - RELOC_SIZE) {
+	warning ("[%s:%s+0x%04lx] reloc location beyond 64K in code resource",
+		 bfd_get_filename (abfd), relsecname, reloffset);
+	continue;
+	}
+
+      unsigned long value =
+	  (bfd_get_32 (abfd, block.contents () + site)
+	   - bfd_section_vma (abfd, symsec) + res_from_sec[symsecndx].offset);
+
+      unsigned char entry[8];
+      unsigned char* es = entry;
+      put_word (es, site);
+      put_word (es, res_from_sec[symsecndx].chain);
+      put_long (es, value);
+
+      std::vector<unsigned char>& table = code_rlocs[(*code).first];
+      table.insert (table.end (), entry, entry + sizeof entry);
+      }
     }
 
-  free (reloc);
-  return res;
+  db[ResKey ("rloc", 0)] = res;
+
+  for (std::map<long, std::vector<unsigned char> >::const_iterator it =
+	   code_rlocs.begin();
+       it != code_rlocs.end();
+       ++it) {
+    Datablock table ((*it).second.size ());
+    memcpy (table.writable_contents (), &(*it).second[0], table.size ());
+    db[ResKey ("rloc", (*it).first)] = table;
+    }
   }
 
 
@@ -612,11 +845,17 @@ process_binary_file (const char* fname, const binary_file_info& normal_info) {
   res_from_sec[bss_sec->index].offset =
       (bfd_section_vma (abfd, bss_sec) - bfd_section_vma (abfd, data_sec));
 
+  /* Code resources whose absolute pointers the startup code can patch,
+     indexed by chain.  */
+  std::map<long, ResKey> code_from_chain;
+
   asection* text_sec = bfd_get_section_by_name (abfd, ".text");
   res_from_sec[text_sec->index].chain = 1;
   res_from_sec[text_sec->index].offset = 0;
 
   db[info.maincode] = make_main_code (abfd, text_sec);
+  if (strncmp (info.maincode.type, "code", 4) == 0)
+    code_from_chain[1] = info.maincode;
 
   for (std::map<const char*,ResKey>::const_iterator it = info.extracode.begin();
        it != info.extracode.end();
@@ -626,6 +865,8 @@ process_binary_file (const char* fname, const binary_file_info& normal_info) {
       res_from_sec[sec->index].chain = (*it).second.id;
       res_from_sec[sec->index].offset = 0;
       db[(*it).second] = make_code (abfd, sec);
+      if (strncmp ((*it).second.type, "code", 4) == 0)
+	code_from_chain[(*it).second.id] = (*it).second;
       }
     else
       error ("[%s] unknown code section '%s'", fname, (*it).first);
@@ -641,14 +882,22 @@ process_binary_file (const char* fname, const binary_file_info& normal_info) {
     bfd_byte* data = static_cast<bfd_byte*>(xmalloc (data_size));
 
     if (get_section_contents (abfd, data_sec, data, 0, data_size)) {
-      asection* reloc_sec = bfd_get_section_by_name (abfd, ".reloc");
-      bfd_size_type reloc_size = (reloc_sec)? bfd_section_size (abfd, reloc_sec)
-					    : 0;
+      bool emitted_relocs = false;
+      for (asection* sec = abfd->sections; sec; sec = sec->next)
+	if ((bfd_get_section_flags (abfd, sec) & SEC_RELOC)
+	    && res_from_sec[sec->index].chain != -1)
+	  emitted_relocs = true;
 
-      if (reloc_size > 0 || info.force_rloc)
-	db[ResKey ("rloc", 0)] =
-	    make_rloc_and_chains (2 + info.extracode.size(), res_from_sec,
-				  abfd, reloc_sec, reloc_size, data, data_size);
+      std::vector<runtime_reloc> relocs;
+      asection* reloc_sec = bfd_get_section_by_name (abfd, ".reloc");
+      if (emitted_relocs)
+	read_emitted_relocs (abfd, res_from_sec, relocs);
+      else if (reloc_sec && bfd_section_size (abfd, reloc_sec) > 0)
+	read_embedded_relocs (abfd, reloc_sec, relocs);
+
+      if (! relocs.empty () || info.force_rloc)
+	make_rloc_and_chains (db, 2 + info.extracode.size(), res_from_sec,
+			      code_from_chain, abfd, relocs, data, data_size);
 
       db[ResKey ("data", 0)] = make_data (data, data_size, total_data_size,
 					  info.data_compression);
@@ -0,0 +1,430 @@
+/* bitmap.cpp: choose the smallest encoding for each bitmap in a family.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#include <string>
+#include <vector>
+
+#include <string.h>
+
+#include "bitmap.hpp"
+#include "pfdio.hpp"
+
+/* A bitmap family is a chain of BitmapType structures, each giving the
+   offset of the next.  Versions 0 to 2 have a 16-byte header, and versions
+   1 and 2 give the offset in 4-byte units.  A version 1 header with a
+   pixel size of 255 marks the start of the version 3 (high-density)
+   bitmaps, whose headers give their own size and the offset in bytes.
+   The header is followed by the color table if there is one, then for a
+   version 2 direct color bitmap the direct color information, and then
+   the pixels, which if compressed are preceded by their compressed size
+   (16 bits, or 32 bits for version 3) including the size itself.  */
+
+enum {
+  FLAG_COMPRESSED = 0x8000,
+  FLAG_HAS_COLOR_TABLE = 0x4000,
+  FLAG_INDIRECT = 0x1000,
+  FLAG_DIRECT_COLOR = 0x0400
+  };
+
+enum {
+  COMPRESSION_SCANLINE = 0,
+  COMPRESSION_RLE = 1,
+  COMPRESSION_PACKBITS = 2,
+  COMPRESSION_NONE = 0xff
+  };
+
+struct bitmap {
+  std::string prefix;		// Header, color table, and direct color info
+  unsigned int version, pixel_size, row_bytes, height;
+  bool marker;			// The high-density marker has no pixels
+  int compression;		// As found in the resource
+  std::string pixels;		// Uncompressed
+  std::string data;		// As it is to be written
+  };
+
+typedef std::string::size_type size_type;
+
+static void
+scanline_encode (std::string& out, const std::string& pixels,
+		 unsigned int row_bytes, unsigned int height) {
+  for (unsigned int r = 0; r < height; r++) {
+    size_type row = r * row_bytes;
+    for (unsigned int x = 0; x < row_bytes; x += 8) {
+      size_type flag_pos = out.size();
+      unsigned char flags = 0;
+      out += '\0';
+      for (unsigned int j = 0; j < 8 && x + j < row_bytes; j++) {
+	char c = pixels[row + x + j];
+	if (r == 0 || c != pixels[row - row_bytes + x + j]) {
+	  flags |= 0x80 >> j;
+	  out += c;
+	  }
+	}
+      out[flag_pos] = flags;
+      }
+    }
+  }
+
+static bool
+scanline_decode (std::string& pixels, const unsigned char* s,
+		 const unsigned char* lim,
+		 unsigned int row_bytes, unsigned int height) {
+  pixels.assign (row_bytes * height, '\0');
+  for (unsigned int r = 0; r < height; r++) {
+    size_type row = r * row_bytes;
+    for (unsigned int x = 0; x < row_bytes; x += 8) {
+      if (s >= lim)  return false;
+      unsigned char flags = *s++;
+      for (unsigned int j = 0; j < 8 && x + j < row_bytes; j++)
+	if (flags & (0x80 >> j)) {
+	  if (s >= lim)  return false;
+	  pixels[row + x + j] = *s++;
+	  }
+	else if (r == 0)
+	  return false;
+	else
+	  pixels[row + x + j] = pixels[row - row_bytes + x + j];
+      }
+    }
+
+  return s == lim;
+  }
+
+// Runs are kept within rows, whether or not the decoder requires it.
+
+static void
+rle_encode (std::string& out, const std::string& pixels,
+	    unsigned int row_bytes, unsigned int height) {
+  for (unsigned int r = 0; r < height; r++) {
+    size_type i = r * row_bytes, lim = i + row_bytes;
+    while (i < lim) {
+      size_type n = 1;
+      while (n < 255 && i + n < lim && pixels[i + n] == pixels[i])
+	n++;
+      out += char (n);
+      out += pixels[i];
+      i += n;
+      }
+    }
+  }
+
+static bool
+rle_decode (std::string& pixels, const unsigned char* s,
+	    const unsigned char* lim, size_type size) {
+  pixels.erase();
+  while (s < lim) {
+    if (lim - s < 2 || s[0] == 0 || pixels.size() + s[0] > size)
+      return false;
+    pixels.append (s[0], s[1]);
+    s += 2;
+    }
+
+  return pixels.size() == size;
+  }
+
+static void
+packbits_encode (std::string& out, const std::string& pixels,
+		 unsigned int row_bytes, unsigned int height) {
+  for (unsigned int r = 0; r < height; r++) {
+    size_type i = r * row_bytes, lim = i + row_bytes;
+    while (i < lim) {
+      size_type n = 1;
+      while (n < 128 && i + n < lim && pixels[i + n] == pixels[i])
+	n++;
+
+      if (n >= 2) {
+	out += char (1 - n);
+	out += pixels[i];
+	i += n;
+	}
+      else {
+	// Gather literals up to the next run of three or more.
+	size_type j = i + 1;
+	while (j < lim && j - i < 128
+	       && !(j + 2 < lim && pixels[j] == pixels[j + 1]
+		    && pixels[j] == pixels[j + 2]))
+	  j++;
+	out += char (j - i - 1);
+	out.append (pixels, i, j - i);
+	i = j;
+	}
+      }
+    }
+  }
+
+static bool
+packbits_decode (std::string& pixels, const unsigned char* s,
+		 const unsigned char* lim, size_type size) {
+  pixels.erase();
+  while (s < lim) {
+    int n = get_sbyte (s);
+    if (n >= 0) {
+      if (lim - s < n + 1 || pixels.size() + n + 1 > size)
+	return false;
+      pixels.append ((const char*) s, n + 1);
+      s += n + 1;
+      }
+    else if (n != -128) {
+      if (s >= lim || pixels.size() + 1 - n > size)
+	return false;
+      pixels.append (1 - n, *s++);
+      }
+    }
+
+  return pixels.size() == size;
+  }
+
+static bool
+decode (const bitmap& bmp, int compression, const std::string& data,
+	std::string& pixels) {
+  size_type size = bmp.row_bytes * bmp.height;
+  const unsigned char* s = (const unsigned char*) data.data();
+  const unsigned char* lim = s + data.size();
+
+  if (compression == COMPRESSION_NONE) {
+    pixels = data;
+    return data.size() == size;
+    }
+
+  size_type field = (bmp.version >= 3)? 4 : 2;
+  if (data.size() < field)
+    return false;
+  unsigned long len = (field == 4)? get_long (s) : get_word (s);
+  if (len != data.size())
+    return false;
+
+  switch (compression) {
+  case COMPRESSION_SCANLINE:
+    return scanline_decode (pixels, s, lim, bmp.row_bytes, bmp.height);
+  case COMPRESSION_RLE:
+    return rle_decode (pixels, s, lim, size);
+  case COMPRESSION_PACKBITS:
+    return packbits_decode (pixels, s, lim, size);
+  default:
+    return false;
+    }
+  }
+
+static std::string
+encode (const bitmap& bmp, int compression) {
+  if (compression == COMPRESSION_NONE)
+    return bmp.pixels;
+
+  size_type field = (bmp.version >= 3)? 4 : 2;
+  std::string out (field, '\0');
+
+  switch (compression) {
+  case COMPRESSION_SCANLINE:
+    scanline_encode (out, bmp.pixels, bmp.row_bytes, bmp.height);
+    break;
+  case COMPRESSION_RLE:
+    rle_encode (out, bmp.pixels, bmp.row_bytes, bmp.height);
+    break;
+  case COMPRESSION_PACKBITS:
+    packbits_encode (out, bmp.pixels, bmp.row_bytes, bmp.height);
+    break;
+    }
+
+  unsigned char buffer[4];
+  unsigned char* s = buffer;
+  if (field == 4)  put_long (s, out.size());
+  else  put_word (s, out.size());
+  out.replace (0, field, (const char*) buffer, field);
+  return out;
+  }
+
+static std::vector<bitmap>
+parse_family (const Datablock& block) {
+  std::vector<bitmap> family;
+  const unsigned char* base = block.contents();
+  unsigned long size = block.size();
+  unsigned long off = 0;
+
+  for (;;) {
+    if (size - off < 16)
+      throw "bitmap header is truncated";
+
+    const unsigned char* s = base + off;
+    bitmap bmp;
+    s += 2;  // Skip the width
+    bmp.height = get_word (s);
+    bmp.row_bytes = get_word (s);
+    unsigned int flags = get_word (s);
+    bmp.pixel_size = get_byte (s);
+    bmp.version = get_byte (s);
+    bmp.marker = (bmp.version == 1 && bmp.pixel_size == 0xff);
+
+    if (bmp.version > 3)
+      throw "unknown bitmap version";
+    if (flags & FLAG_INDIRECT)
+      throw "indirect bitmaps can't be handled";
+
+    unsigned long header = 16, next;
+    s = base + off + 10;
+    if (bmp.version == 3) {
+      header = get_byte (s);
+      if (header < 24)
+	throw "bitmap header is too small";
+      s = base + off + 20;
+      next = get_long (s);
+      }
+    else
+      next = (bmp.version >= 1)? get_word (s) * 4 : 0;
+
+    if (bmp.marker) {
+      bmp.row_bytes = bmp.height = 0;
+      flags = 0;
+      }
+
+    unsigned long prefix = header;
+    if (flags & FLAG_HAS_COLOR_TABLE) {
+      if (size - off < prefix + 2)
+	throw "bitmap color table is truncated";
+      s = base + off + prefix;
+      prefix += 2 + 4 * get_word (s);
+      }
+    if (bmp.version == 2 && (flags & FLAG_DIRECT_COLOR))
+      prefix += 8;
+    if (size - off < prefix)
+      throw "bitmap header is truncated";
+
+    bmp.prefix.assign ((const char*) base + off, prefix);
+
+    unsigned long extent = prefix;
+    if (flags & FLAG_COMPRESSED) {
+      bmp.compression = (bmp.version >= 2)? base[off + 13]
+					  : int (COMPRESSION_SCANLINE);
+      s = base + off + prefix;
+      if (size - off < prefix + ((bmp.version >= 3)? 4 : 2))
+	throw "compressed bitmap is truncated";
+      extent += (bmp.version >= 3)? get_long (s) : get_word (s);
+      }
+    else {
+      bmp.compression = COMPRESSION_NONE;
+      extent += bmp.row_bytes * bmp.height;
+      }
+
+    if (extent > size - off)
+      throw "bitmap is truncated";
+    if (next != 0 && next < extent)
+      throw "bitmaps in family overlap";
+
+    bmp.data.assign ((const char*) base + off + prefix, extent - prefix);
+    if (!decode (bmp, bmp.compression, bmp.data, bmp.pixels))
+      throw "compressed bitmap is corrupt";
+
+    family.push_back (bmp);
+
+    if (next == 0) {
+      // Anything more than alignment padding is something we don't know.
+      if (size - off - extent > 3)
+	throw "unexpected data after last bitmap";
+      break;
+      }
+
+    off += next;
+    if (off > size)
+      throw "bitmap family chain runs off the end";
+    }
+
+  return family;
+  }
+
+// Rebuilds the family, setting each bitmap's compression and chain offset.
+
+static Datablock
+build_family (std::vector<bitmap>& family) {
+  std::string out;
+
+  for (std::vector<bitmap>::iterator it = family.begin();
+       it != family.end();
+       ++it) {
+    bitmap& bmp = *it;
+    bool last = (it + 1 == family.end());
+    size_type start = out.size();
+    out += bmp.prefix;
+    out += bmp.data;
+    if (!last)
+      while (out.size() % 4 != 0)  out += '\0';
+
+    unsigned long next = last? 0 : out.size() - start;
+    unsigned char* s = (unsigned char*) &out[start];
+
+    if (!bmp.marker) {
+      const unsigned char* f = s + 6;
+      unsigned int flags = get_word (f);
+      if (bmp.compression == COMPRESSION_NONE)  flags &= ~FLAG_COMPRESSED;
+      else  flags |= FLAG_COMPRESSED;
+      unsigned char* w = s + 6;
+      put_word (w, flags);
+      if (bmp.version >= 2)
+	s[13] = bmp.compression;
+      }
+
+    unsigned char* n = s + ((bmp.version == 3)? 20 : 10);
+    if (bmp.version == 3)
+      put_long (n, next);
+    else if (bmp.version >= 1) {
+      if (next / 4 > 0xffff)
+	throw "bitmap is too large to chain";
+      put_word (n, next / 4);
+      }
+    else if (!last)
+      throw "version 0 bitmap can't be followed by another";
+    }
+
+  Datablock block (out.size());
+  memcpy (block.writable_contents(), out.data(), out.size());
+  return block;
+  }
+
+Datablock
+optimize_bitmap_family (const Datablock& block, unsigned int methods) {
+  std::vector<bitmap> family = parse_family (block);
+
+  for (std::vector<bitmap>::iterator it = family.begin();
+       it != family.end();
+       ++it) {
+    bitmap& bmp = *it;
+    if (bmp.marker || bmp.version == 0)
+      continue;
+
+    std::vector<int> candidates;
+    candidates.push_back (COMPRESSION_NONE);
+    if (methods & BITMAP_SCANLINE)
+      candidates.push_back (COMPRESSION_SCANLINE);
+    if (bmp.version >= 2 && (methods & BITMAP_RLE))
+      candidates.push_back (COMPRESSION_RLE);
+    // 16-bit PackBits works in pixels rather than bytes.
+    if (bmp.version >= 2 && (methods & BITMAP_PACKBITS) && bmp.pixel_size <= 8)
+      candidates.push_back (COMPRESSION_PACKBITS);
+
+    for (std::vector<int>::iterator c = candidates.begin();
+	 c != candidates.end();
+	 ++c) {
+      std::string data = encode (bmp, *c);
+      std::string pixels;
+      if (data.size() < bmp.data.size()
+	  && decode (bmp, *c, data, pixels) && pixels == bmp.pixels) {
+	bmp.data.swap (data);
+	bmp.compression = *c;
+	}
+      }
+    }
+
+  Datablock result = build_family (family);
+
+  // Check the whole family again, chain and all.
+  std::vector<bitmap> check = parse_family (result);
+  if (check.size() != family.size())
+    throw "optimized bitmap family failed verification";
+  for (size_type i = 0; i < check.size(); i++)
+    if (check[i].pixels != family[i].pixels)
+      throw "optimized bitmap family failed verification";
+
+  return result;
+  }
@@ -0,0 +1,28 @@
+/* bitmap.hpp: header file for bitmap.cpp.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#ifndef BITMAP_HPP
+#define BITMAP_HPP
+
+#include "pfd.hpp"
+
+// The bitmap compression methods which may be used, as a mask.
+enum {
+  BITMAP_SCANLINE = 1,
+  BITMAP_RLE = 2,
+  BITMAP_PACKBITS = 4
+  };
+
+/* Re-encodes each bitmap of the bitmap family BLOCK (a 'Tbmp' or 'tAIB'
+   resource) in whichever of its current encoding, no compression, or the
+   METHODS that its version supports is smallest, and checks that each
+   new encoding decodes to exactly the original pixels.  Throws a message
+   if BLOCK is not a bitmap family that can be handled.  */
+
+Datablock optimize_bitmap_family (const Datablock& block, unsigned int methods);
+
+#endif
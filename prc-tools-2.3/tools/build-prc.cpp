@@ -45,6 +45,7 @@
 #include "utils.h"
 #include "def.h"
 #include "binres.hpp"
+#include "bitmap.hpp"
 #include "pfd.hpp"
 #include "pfdio.hpp"
 
@@ -82,6 +83,9 @@ usage () {
 	 "Set database attributes");
   propt ("-z N, --compress-data N",
 	 "Set data resource compression method (0--7)");
+  propt ("--optimize-bitmaps[=LIST]",
+	 "Recompress bitmaps with the smallest of the methods in LIST");
+  propt ("", "(scanline, rle, packbits; all by default)");
   propt ("--no-check-header", "Suppress database header validity warnings");
   propt ("--no-check-resources",
 	 "Suppress diagnosis of missing vital resources");
@@ -104,6 +108,7 @@ enum {
   OPTION_NO_CHECK_HEADER,
   OPTION_NO_CHECK_RESOURCES,
   OPTION_NO_CHECK,
+  OPTION_OPTIMIZE_BITMAPS,
   OPTION_HELP,
   OPTION_VERSION
   };
@@ -143,6 +148,7 @@ static struct option longopts[] = {
   { "no-check-header", no_argument, NULL, OPTION_NO_CHECK_HEADER },
   { "no-check-resources", no_argument, NULL, OPTION_NO_CHECK_RESOURCES },
   { "no-check", no_argument, NULL, OPTION_NO_CHECK },
+  { "optimize-bitmaps", optional_argument, NULL, OPTION_OPTIMIZE_BITMAPS },
 
   { "help", no_argument, NULL, OPTION_HELP },
   { "version", no_argument, NULL, OPTION_VERSION },
@@ -173,6 +179,55 @@ add_resource (const char* origin, const ResKey& key, const Datablock& data) {
   }
 
 
+/* Parses a comma-separated list of bitmap compression methods.  */
+
+static unsigned int
+parse_bitmap_methods (const char* list) {
+  unsigned int methods = 0;
+
+  while (*list) {
+    const char* end = strchr (list, ',');
+    if (end == NULL)  end = list + strlen (list);
+    std::string name (list, end - list);
+
+    if (name == "scanline")		methods |= BITMAP_SCANLINE;
+    else if (name == "rle")		methods |= BITMAP_RLE;
+    else if (name == "packbits")	methods |= BITMAP_PACKBITS;
+    else
+      error ("unknown bitmap compression method '%s'", name.c_str());
+
+    list = (*end)? end + 1 : end;
+    }
+
+  return methods;
+  }
+
+static void
+optimize_bitmaps (unsigned int methods) {
+  unsigned long before = 0, after = 0;
+
+  for (ResourceDatabase::iterator it = db.begin(); it != db.end(); ++it) {
+    const ResKey& key = (*it).first;
+    if (strncmp (key.type, "Tbmp", 4) != 0 && strncmp (key.type, "tAIB", 4) != 0)
+      continue;
+
+    try {
+      Datablock block = optimize_bitmap_family ((*it).second, methods);
+      before += (*it).second.size();
+      if (block.size() < (*it).second.size())
+	(*it).second = block;
+      after += (*it).second.size();
+      } catch (const char* message) {
+      warning ("[%s] '%.4s' #%u: %s; left as is", prov[key].c_str(),
+	       key.type, key.id, message);
+      }
+    }
+
+  if (before > 0)
+    printf ("%s: bitmaps optimized from %lu to %lu bytes (%lu saved)\n",
+	    progname, before, after, before - after);
+  }
+
 static void
 update_bininfo_maincode_id (const ResourceDatabase& db) {
   while (db.find (bininfo.maincode) != db.end())
@@ -509,6 +564,7 @@ main (int argc, char** argv) {
 
   char* output_fname = NULL;
   bool check_header = true;
+  unsigned int bitmap_methods = 0;
 
   set_progname (argv[0]);
 
@@ -636,6 +692,11 @@ main (int argc, char** argv) {
       if (superior (check_resources, option_pri))  check_resources = NULL;
       break;
 
+    case OPTION_OPTIMIZE_BITMAPS:
+      bitmap_methods = optarg? parse_bitmap_methods (optarg)
+		       : BITMAP_SCANLINE | BITMAP_RLE | BITMAP_PACKBITS;
+      break;
+
     case OPTION_HELP: {
       usage();
       printf ("Supported binary targets:\n");
@@ -786,6 +847,9 @@ main (int argc, char** argv) {
       error (err.format, err.fname);
       }
 
+  if (nerrors == 0 && bitmap_methods)
+    optimize_bitmaps (bitmap_methods);
+
   if (nerrors == 0 && check_resources)
     check_resources (output_fname, db, bininfo);
 
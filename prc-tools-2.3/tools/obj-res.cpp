@@ -21,8 +21,12 @@
  * krab@california.daimi.aau.dk
  */
 
+#include <vector>
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "getopt.h"
 
@@ -32,13 +36,16 @@
 
 static void
 usage() {
-  printf ("Usage: %s [-l] [-L export.file] [-z #] bfd.file\n", progname);
+  printf ("Usage: %s [-l] [-L export.file] [-z #] [-o file.ro] bfd.file\n",
+	  progname);
   printf ("Options:\n");
   propt_tab = 16;
   propt ("-l", "Generate GLib resources");
   propt ("-L EXPORT.FILE",
 	 "Generate SysLib resources (EXPORT.FILE is unsupported)");
   propt ("-z NUM", "Set data compression level (0--7; by default, 0)");
+  propt ("-o FILE.ro",
+	 "Write all resources to FILE.ro rather than to separate .grc files");
   }
 
 enum {
@@ -46,9 +53,10 @@ enum {
   OPTION_VERSION
   };
 
-static const char shortopts[] = "lL:z:";
+static const char shortopts[] = "lL:z:o:";
 
 static struct option longopts[] = {
+  { "output", required_argument, NULL, 'o' },
   { "help", no_argument, NULL, OPTION_HELP },
   { "version", no_argument, NULL, OPTION_VERSION },
   { NULL, no_argument, NULL, 0 }
@@ -57,6 +65,7 @@ static struct option longopts[] = {
 int
 main (int argc, char** argv) {
   bool work_desired = true;
+  const char* output_fname = NULL;
   int c;
 
   set_progname (argv[0]);
@@ -90,6 +99,10 @@ main (int argc, char** argv) {
       info.data_compression = atoi (optarg);
       break;
 
+    case 'o':
+      output_fname = optarg;
+      break;
+
     case OPTION_HELP:
       usage();
       work_desired = false;
@@ -111,7 +124,33 @@ main (int argc, char** argv) {
 
   ResourceDatabase out = process_binary_file (argv[optind], info);
 
-  if (nerrors == 0) {
+  if (nerrors == 0 && output_fname) {
+    // Write a single resource database, which build-prc reads directly.
+    // Stripping the extension only shortens the copy, so it fits.
+    const char* infname = argv[optind];
+    std::vector<char> buffer (infname, infname + strlen (infname) + 1);
+    init_database_header (&out);
+    strncpy (out.name, basename_with_changed_extension (&buffer[0], ""), 32);
+    out.name[31] = '\0';
+
+    time_t now = time (NULL);
+    struct tm* now_tm = localtime (&now);
+    out.created = out.modified = *now_tm;
+
+    FILE* f = fopen (output_fname, "wb");
+    if (f) {
+      if (out.write (f))
+	fclose (f);
+      else {
+	error ("error writing to '%s': @P", output_fname);
+	fclose (f);
+	remove (output_fname);
+	}
+      }
+    else
+      error ("can't write to '%s': @P", output_fname);
+    }
+  else if (nerrors == 0) {
     char *basename = basename_with_changed_extension (argv[optind], NULL);
     for (ResourceDatabase::const_iterator it = out.begin();
 	 it != out.end();
@@ -0,0 +1,1339 @@
+/* pdb-tool.cpp: convert between record databases and host data files.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "getopt.h"
+#include "utils.h"
+#include "pfd.hpp"
+#include "pfdio.hpp"
+
+void
+usage () {
+  printf ("Usage: %s import [options] -o outfile.pdb [infile]\n"
+	  "       %s export [options] infile.pdb\n", progname, progname);
+
+  printf ("Options:\n");
+  propt ("-o FILE, --output FILE", "Set output file name");
+  propt ("-f FMT, --format FMT",
+	 "Set data file format: csv (default), jsonl, or binary");
+  propt ("-k LIST, --columns LIST",
+	 "Name the leading CSV columns (default 'uid,category,attributes')");
+  propt ("--header", "Skip the first line of a CSV data file");
+  propt ("--category-names", "Export categories by name rather than number");
+  propt ("-u NUM, --uid-base NUM", "Set the first unique ID to assign");
+  propt ("-S KEY, --sort-key KEY", "Sort records by KEY, which is one of");
+  propt ("", "bytes:OFFSET:LENGTH, string:OFFSET, or field:NUMBER");
+  propt ("-x, --key-index[=WIDTH]",
+	 "Store an index of WIDTH-byte key prefixes as SortInfo");
+  propt ("--index-interval NUM", "Index the key of every NUM'th record");
+  propt ("--shard-size NUM",
+	 "Split more than NUM records into several databases");
+  propt ("-z, --compress[=SIZE]",
+	 "Compress records using a SIZE-byte dictionary as AppInfo");
+  propt ("-a FILE, --appinfo FILE", "Add (or export) an AppInfo block");
+  propt ("-s FILE, --sortinfo FILE", "Add (or export) a SortInfo block");
+  propt ("-t TYPE, --type TYPE", "Set database type (default 'DATA')");
+  propt ("-c CRID, --creator CRID", "Set database creator");
+  propt ("-n NAME, --name NAME", "Set database name");
+  propt ("-m NUM, --modification-number NUM",
+	 "Set database modification number");
+  propt ("-v NUM, --version-number NUM", "Set database version number");
+  propt ("--backup", "Set the database's backup attribute");
+  }
+
+enum {
+  OPTION_HEADER = 150,
+  OPTION_CATEGORY_NAMES,
+  OPTION_BACKUP,
+  OPTION_INDEX_INTERVAL,
+  OPTION_SHARD_SIZE,
+  OPTION_HELP,
+  OPTION_VERSION
+  };
+
+static const char shortopts[] = "o:f:k:u:S:x::z::a:s:t:c:n:m:v:";
+
+static struct option longopts[] = {
+  { "output", required_argument, NULL, 'o' },
+  { "format", required_argument, NULL, 'f' },
+  { "columns", required_argument, NULL, 'k' },
+  { "uid-base", required_argument, NULL, 'u' },
+  { "sort-key", required_argument, NULL, 'S' },
+  { "key-index", optional_argument, NULL, 'x' },
+  { "compress", optional_argument, NULL, 'z' },
+  { "appinfo", required_argument, NULL, 'a' },
+  { "sortinfo", required_argument, NULL, 's' },
+  { "type", required_argument, NULL, 't' },
+  { "creator", required_argument, NULL, 'c' },
+  { "name", required_argument, NULL, 'n' },
+  { "modification-number", required_argument, NULL, 'm' },
+  { "version-number", required_argument, NULL, 'v' },
+
+  { "header", no_argument, NULL, OPTION_HEADER },
+  { "category-names", no_argument, NULL, OPTION_CATEGORY_NAMES },
+  { "backup", no_argument, NULL, OPTION_BACKUP },
+  { "index-interval", required_argument, NULL, OPTION_INDEX_INTERVAL },
+  { "shard-size", required_argument, NULL, OPTION_SHARD_SIZE },
+
+  { "help", no_argument, NULL, OPTION_HELP },
+  { "version", no_argument, NULL, OPTION_VERSION },
+  { NULL, no_argument, NULL, 0 }
+  };
+
+
+enum data_format { DF_CSV, DF_JSONL, DF_BINARY };
+
+enum column_kind { COL_UID, COL_CATEGORY, COL_ATTRIBUTES, COL_FIELD, COL_SKIP };
+
+static enum data_format format = DF_CSV;
+static std::vector<column_kind> columns;
+static bool csv_header = false;
+static bool category_names = false;
+static unsigned long uid_base = 1;
+static SortKey* sort_key = NULL;
+static unsigned int key_index_width = 0;
+static unsigned int key_index_interval = 0;
+static unsigned long shard_size = 0xffff;
+static unsigned long dictionary_size = 0;
+
+
+static void
+parse_columns (const char* list) {
+  columns.clear();
+
+  while (*list) {
+    const char* end = strchr (list, ',');
+    if (end == NULL)  end = list + strlen (list);
+    std::string name (list, end - list);
+
+    if (name == "uid")			columns.push_back (COL_UID);
+    else if (name == "category")	columns.push_back (COL_CATEGORY);
+    else if (name == "attributes")	columns.push_back (COL_ATTRIBUTES);
+    else if (name == "field")		columns.push_back (COL_FIELD);
+    else if (name == "-")		columns.push_back (COL_SKIP);
+    else
+      error ("unknown column name '%s'", name.c_str());
+
+    list = (*end)? end + 1 : end;
+    }
+  }
+
+
+/* Parses a sort key specification, as described in the usage above.  */
+
+static SortKey*
+parse_sort_key (const char* spec) {
+  const char* colon = strchr (spec, ':');
+  if (colon == NULL)
+    return NULL;
+
+  std::string kind (spec, colon - spec);
+  char* end;
+  unsigned long param = strtoul (colon + 1, &end, 0);
+  if (end == colon + 1 || param > 0xffff)
+    return NULL;
+
+  if (kind == "bytes" && *end == ':') {
+    const char* lenstr = end + 1;
+    unsigned long length = strtoul (lenstr, &end, 0);
+    if (end == lenstr || *end != '\0' || length == 0 || length > 0xffff)
+      return NULL;
+    return new SortKey (SortKey::BYTES, param, length);
+    }
+  else if (*end != '\0')
+    return NULL;
+  else if (kind == "string")
+    return new SortKey (SortKey::STRING, param);
+  else if (kind == "field")
+    return new SortKey (SortKey::FIELD, param);
+  else
+    return NULL;
+  }
+
+
+/* The standard category AppInfo layout, from Category.h:  a word of
+   "renamed" flags, then 16 labels of 16 characters, 16 unique IDs, the
+   last unique ID, and a padding byte.  */
+
+static const long category_appinfo_size = 2 + 16 * 16 + 16 + 2;
+
+class CategoryMap {
+public:
+  CategoryMap () : loaded (false), changed (false) { }
+
+  void load (const Datablock& appinfo);
+  unsigned int lookup (const char* name);
+  const char* name (unsigned int category) const;
+  Datablock update (const Datablock& appinfo) const;
+
+private:
+  std::string label[16];
+  bool loaded, changed;
+  };
+
+void
+CategoryMap::load (const Datablock& appinfo) {
+  if (appinfo.size() < category_appinfo_size)
+    return;
+
+  const unsigned char* s = appinfo.contents() + 2;
+  for (int i = 0; i < 16; i++, s += 16) {
+    const void* nul = memchr (s, '\0', 16);
+    label[i].assign ((const char*) s, nul? (const unsigned char*) nul - s : 16);
+    }
+  loaded = true;
+  }
+
+/* Returns the category index for NAME, which is either a number or a label,
+   adding it as a new category if it is a label that hasn't been seen.  */
+
+unsigned int
+CategoryMap::lookup (const char* name) {
+  char* end;
+  unsigned long n = strtoul (name, &end, 0);
+  if (*name && *end == '\0') {
+    if (n > 15)
+      throw "category number must be between 0 and 15";
+    return n;
+    }
+
+  if (!loaded) {
+    label[0] = "Unfiled";
+    loaded = true;
+    }
+
+  int i;
+  for (i = 0; i < 16; i++)
+    if (label[i] == name)
+      return i;
+
+  if (strlen (name) > 15)
+    throw "category name is longer than 15 characters";
+
+  for (i = 0; i < 16; i++)
+    if (label[i].empty()) {
+      label[i] = name;
+      changed = true;
+      return i;
+      }
+
+  throw "too many category names";
+  }
+
+const char*
+CategoryMap::name (unsigned int category) const {
+  return (loaded && !label[category].empty())? label[category].c_str() : NULL;
+  }
+
+/* Returns APPINFO with the category labels added by lookup() filled in,
+   creating a new standard category AppInfo block if APPINFO is empty.  */
+
+Datablock
+CategoryMap::update (const Datablock& appinfo) const {
+  if (!changed)
+    return appinfo;
+
+  if (appinfo.size() == 0) {
+    Datablock block (category_appinfo_size);
+    unsigned char* s = block.writable_contents();
+    memset (s, 0, block.size());
+    for (int i = 0; i < 16; i++)
+      if (!label[i].empty()) {
+	strncpy ((char*) s + 2 + 16 * i, label[i].c_str(), 16);
+	s[2 + 16 * 16 + i] = i;
+	s[2 + 16 * 16 + 16] = i;
+	}
+    return block;
+    }
+  else if (appinfo.size() >= category_appinfo_size) {
+    Datablock block = appinfo;
+    unsigned char* s = block.writable_contents();
+    for (int i = 0; i < 16; i++)
+      if (s[2 + 16 * i] == '\0' && !label[i].empty()) {
+	strncpy ((char*) s + 2 + 16 * i, label[i].c_str(), 16);
+	s[2 + 16 * 16 + i] = i;
+	if (s[2 + 16 * 16 + 16] < i)  s[2 + 16 * 16 + 16] = i;
+	}
+    return block;
+    }
+  else
+    throw "AppInfo block is too small to hold category names";
+  }
+
+static CategoryMap categories;
+
+
+struct attribute_name {
+  const char* name;
+  bool Record::*flag;
+  };
+
+static const struct attribute_name attribute_names[] = {
+  { "delete", &Record::deletable },
+  { "dirty", &Record::dirty },
+  { "busy", &Record::busy },
+  { "secret", &Record::secret },
+  { NULL, NULL }
+  };
+
+static void
+clear_record_attributes (Record& rec) {
+  rec.category = 0;
+  rec.deletable = rec.dirty = rec.busy = rec.secret = false;
+  }
+
+/* Sets REC's attributes from a list of attribute names separated by
+   spaces or '|' characters.  */
+
+static void
+parse_record_attributes (Record& rec, const char* list) {
+  while (*list) {
+    size_t len = strcspn (list, " |");
+    if (len > 0) {
+      const struct attribute_name* a;
+      for (a = attribute_names; a->name; a++)
+	if (strlen (a->name) == len && strncmp (a->name, list, len) == 0)
+	  break;
+
+      if (a->name == NULL)
+	throw "unknown record attribute";
+
+      rec.*(a->flag) = true;
+      list += len;
+      }
+    else
+      list++;
+    }
+  }
+
+static std::string
+record_attributes_string (const Record& rec) {
+  std::string s;
+  for (const struct attribute_name* a = attribute_names; a->name; a++)
+    if (rec.*(a->flag)) {
+      if (!s.empty())  s += ' ';
+      s += a->name;
+      }
+  return s;
+  }
+
+
+/* Unique IDs given in the data file are used as is, and the other records
+   are numbered from UID_BASE upwards, skipping IDs already in use.  */
+
+class UniqueIDs {
+public:
+  UniqueIDs () : used (0x1000000), next (uid_base), max (0) { }
+
+  RecKey use (unsigned long uid);
+  RecKey assign ();
+  RecKey seed () const { return max + 1; }
+
+private:
+  std::vector<bool> used;
+  unsigned long next, max;
+  };
+
+RecKey
+UniqueIDs::use (unsigned long uid) {
+  if (uid > 0xffffff)
+    throw "unique ID must be less than 2^24";
+  if (used[uid])
+    throw "duplicate unique ID";
+
+  used[uid] = true;
+  if (uid > max)  max = uid;
+  return uid;
+  }
+
+RecKey
+UniqueIDs::assign () {
+  while (next <= 0xffffff && used[next])
+    next++;
+
+  if (next > 0xffffff)
+    throw "ran out of unique IDs";
+
+  return use (next);
+  }
+
+
+/* Builds a record body from string FIELDS, each terminated by a NUL as
+   is usual for Palm OS databases.  */
+
+static Datablock
+datablock_of_fields (const std::vector<std::string>& fields) {
+  long size = 0;
+  for (std::vector<std::string>::const_iterator it = fields.begin();
+       it != fields.end();
+       ++it)
+    size += (*it).size() + 1;
+
+  Datablock block (size);
+  unsigned char* s = block.writable_contents();
+  for (std::vector<std::string>::const_iterator it = fields.begin();
+       it != fields.end();
+       ++it) {
+    memcpy (s, (*it).data(), (*it).size());
+    s += (*it).size();
+    *s++ = '\0';
+    }
+
+  return block;
+  }
+
+static Datablock
+datablock_of_string (const std::string& str) {
+  Datablock block (str.size());
+  memcpy (block.writable_contents(), str.data(), str.size());
+  return block;
+  }
+
+static void
+split_fields (const Datablock& block, std::vector<std::string>& fields) {
+  const char* s = (const char*) block.contents();
+  const char* lim = s + block.size();
+
+  fields.clear();
+  while (s < lim) {
+    const char* end = (const char*) memchr (s, '\0', lim - s);
+    if (end == NULL)  end = lim;
+    fields.push_back (std::string (s, end - s));
+    s = end + 1;
+    }
+  }
+
+
+/* Reads one CSV row from F into FIELDS, following the usual conventions:
+   fields containing commas, quotes, or line breaks are enclosed in double
+   quotes, and quotes within them are doubled.  Returns false at EOF.  */
+
+static bool
+read_csv_row (FILE* f, std::vector<std::string>& fields,
+	      unsigned long& lineno) {
+  int c = getc (f);
+  if (c == EOF)
+    return false;
+
+  fields.clear();
+  fields.push_back (std::string());
+  bool quoted = false;
+
+  for (; c != EOF; c = getc (f)) {
+    std::string& field = fields.back();
+
+    if (quoted) {
+      if (c == '"') {
+	c = getc (f);
+	if (c == '"')
+	  field += '"';
+	else {
+	  quoted = false;
+	  ungetc (c, f);
+	  }
+	}
+      else {
+	if (c == '\n')  lineno++;
+	field += c;
+	}
+      }
+    else if (c == '"')
+      quoted = true;
+    else if (c == ',')
+      fields.push_back (std::string());
+    else if (c == '\n')
+      break;
+    else if (c != '\r')
+      field += c;
+    }
+
+  if (quoted)
+    throw "unterminated quoted field";
+
+  lineno++;
+  return true;
+  }
+
+static void
+write_csv_field (FILE* f, const std::string& field) {
+  if (field.find_first_of (",\"\r\n") == std::string::npos
+      && (field.empty() || (field[0] != ' ' && field[field.size() - 1] != ' ')))
+    fwrite (field.data(), 1, field.size(), f);
+  else {
+    putc ('"', f);
+    for (std::string::const_iterator it = field.begin();
+	 it != field.end();
+	 ++it) {
+      if (*it == '"')  putc ('"', f);
+      putc (*it, f);
+      }
+    putc ('"', f);
+    }
+  }
+
+
+/* A minimal parser for the flat JSON objects used for JSON lines files:
+   values may be strings, integers, arrays of strings, true, false, or null.
+   Strings are byte strings, so \u escapes must be in the range 0--0xff.  */
+
+class JsonLine {
+public:
+  JsonLine (const char* line) : s (line) { }
+
+  bool next_member (std::string& key);
+  bool is_string () { skip_space(); return *s == '"'; }
+  bool is_array () { skip_space(); return *s == '['; }
+  std::string string_value ();
+  unsigned long number_value ();
+  void array_value (std::vector<std::string>& values);
+  void skip_value ();
+  void end ();
+
+private:
+  void skip_space () { while (isspace ((unsigned char) *s))  s++; }
+  void expect (char c);
+
+  const char* s;
+  };
+
+void
+JsonLine::expect (char c) {
+  skip_space();
+  if (*s != c)
+    throw "malformed JSON object";
+  s++;
+  }
+
+/* Reads the next member's key, leaving the value to be read.  Returns false
+   at the end of the object.  */
+
+bool
+JsonLine::next_member (std::string& key) {
+  skip_space();
+  if (*s == '{')
+    s++;
+  else if (*s == ',')
+    s++;
+  else if (*s == '}') {
+    s++;
+    return false;
+    }
+  else
+    throw "malformed JSON object";
+
+  skip_space();
+  if (*s == '}') {
+    s++;
+    return false;
+    }
+
+  key = string_value();
+  expect (':');
+  return true;
+  }
+
+std::string
+JsonLine::string_value () {
+  std::string str;
+
+  expect ('"');
+  while (*s != '"') {
+    if (*s == '\0')
+      throw "unterminated JSON string";
+    else if (*s != '\\')
+      str += *s++;
+    else {
+      s++;
+      switch (*s++) {
+      case 'b':  str += '\b';  break;
+      case 'f':  str += '\f';  break;
+      case 'n':  str += '\n';  break;
+      case 'r':  str += '\r';  break;
+      case 't':  str += '\t';  break;
+      case 'u': {
+	char hex[5];
+	strncpy (hex, s, 4);
+	hex[4] = '\0';
+	char* end;
+	unsigned long c = strtoul (hex, &end, 16);
+	if (end != hex + 4)
+	  throw "malformed \\u escape in JSON string";
+	if (c > 0xff)
+	  throw "\\u escapes must be between \\u0000 and \\u00ff";
+	str += char (c);
+	s += 4;
+	}
+	break;
+      case '\0':
+	throw "unterminated JSON string";
+      default:
+	str += s[-1];
+	break;
+	}
+      }
+    }
+  s++;
+
+  return str;
+  }
+
+unsigned long
+JsonLine::number_value () {
+  skip_space();
+  char* end;
+  unsigned long n = strtoul (s, &end, 10);
+  if (end == s)
+    throw "expected a number in JSON object";
+  s = end;
+  return n;
+  }
+
+void
+JsonLine::array_value (std::vector<std::string>& values) {
+  values.clear();
+  expect ('[');
+  skip_space();
+  if (*s == ']') {
+    s++;
+    return;
+    }
+
+  do
+    values.push_back (string_value());
+  while (skip_space(), *s == ',' && s++);
+
+  expect (']');
+  }
+
+void
+JsonLine::skip_value () {
+  skip_space();
+  if (*s == '"')
+    string_value();
+  else if (*s == '[') {
+    std::vector<std::string> values;
+    array_value (values);
+    }
+  else
+    while (*s && *s != ',' && *s != '}' && !isspace ((unsigned char) *s))
+      s++;
+  }
+
+void
+JsonLine::end () {
+  skip_space();
+  if (*s != '\0')
+    throw "trailing characters after JSON object";
+  }
+
+static void
+write_json_string (FILE* f, const std::string& str) {
+  putc ('"', f);
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
+    unsigned char c = *it;
+    if (c == '"' || c == '\\')
+      putc ('\\', f), putc (c, f);
+    else if (c >= 0x20 && c < 0x7f)
+      putc (c, f);
+    else if (c == '\n')
+      fputs ("\\n", f);
+    else
+      fprintf (f, "\\u%04x", c);
+    }
+  putc ('"', f);
+  }
+
+static Datablock
+datablock_of_hex (const std::string& hex) {
+  if (hex.size() % 2 != 0)
+    throw "odd number of hex digits";
+
+  Datablock block (hex.size() / 2);
+  unsigned char* s = block.writable_contents();
+  for (std::string::size_type i = 0; i < hex.size(); i += 2) {
+    char byte[3] = { hex[i], hex[i + 1], '\0' };
+    char* end;
+    *s++ = strtoul (byte, &end, 16);
+    if (end != byte + 2)
+      throw "invalid hex digit";
+    }
+
+  return block;
+  }
+
+
+/* Each of these reads one record from F into REC and sets KEY to its
+   unique ID, returning false at EOF.  */
+
+static bool
+read_csv_record (FILE* f, unsigned long& lineno,
+		 Record& rec, RecKey& key, UniqueIDs& uids) {
+  static std::vector<std::string> row, fields;
+
+  if (!read_csv_row (f, row, lineno))
+    return false;
+
+  clear_record_attributes (rec);
+  bool have_uid = false;
+  fields.clear();
+
+  for (std::vector<std::string>::size_type i = 0; i < row.size(); i++)
+    switch ((i < columns.size())? columns[i] : COL_FIELD) {
+    case COL_UID:
+      if (!row[i].empty()) {
+	key = uids.use (strtoul (row[i].c_str(), NULL, 0));
+	have_uid = true;
+	}
+      break;
+
+    case COL_CATEGORY:
+      if (!row[i].empty())
+	rec.category = categories.lookup (row[i].c_str());
+      break;
+
+    case COL_ATTRIBUTES:
+      parse_record_attributes (rec, row[i].c_str());
+      break;
+
+    case COL_FIELD:
+      fields.push_back (row[i]);
+      break;
+
+    case COL_SKIP:
+      break;
+      }
+
+  static_cast<Datablock&>(rec) = datablock_of_fields (fields);
+
+  if (!have_uid)
+    key = uids.assign();
+
+  return true;
+  }
+
+static bool
+read_jsonl_record (FILE* f, unsigned long& lineno,
+		   Record& rec, RecKey& key, UniqueIDs& uids) {
+  static std::string line;
+  static std::vector<std::string> values;
+  int c;
+
+  do {
+    line.clear();
+    while ((c = getc (f)) != EOF && c != '\n')
+      line += c;
+
+    if (c == EOF && line.empty())
+      return false;
+
+    lineno++;
+    }
+  while (line.find_first_not_of (" \t\r") == std::string::npos);
+
+  clear_record_attributes (rec);
+  static_cast<Datablock&>(rec) = Datablock();
+  bool have_uid = false;
+
+  JsonLine json (line.c_str());
+  std::string member;
+  while (json.next_member (member))
+    if (member == "uid") {
+      key = uids.use (json.number_value());
+      have_uid = true;
+      }
+    else if (member == "category") {
+      if (json.is_string())
+	rec.category = categories.lookup (json.string_value().c_str());
+      else {
+	unsigned long n = json.number_value();
+	if (n > 15)
+	  throw "category number must be between 0 and 15";
+	rec.category = n;
+	}
+      }
+    else if (member == "attributes") {
+      if (json.is_array()) {
+	json.array_value (values);
+	for (std::vector<std::string>::const_iterator it = values.begin();
+	     it != values.end();
+	     ++it)
+	  parse_record_attributes (rec, (*it).c_str());
+	}
+      else
+	parse_record_attributes (rec, json.string_value().c_str());
+      }
+    else if (member == "data")
+      static_cast<Datablock&>(rec) = datablock_of_string (json.string_value());
+    else if (member == "hex")
+      static_cast<Datablock&>(rec) = datablock_of_hex (json.string_value());
+    else if (member == "fields") {
+      json.array_value (values);
+      static_cast<Datablock&>(rec) = datablock_of_fields (values);
+      }
+    else
+      json.skip_value();
+
+  json.end();
+
+  if (!have_uid)
+    key = uids.assign();
+
+  return true;
+  }
+
+/* The binary format is a sequence of records, each preceded by an 8-byte
+   header:  its length as a big-endian long, then its attribute byte and
+   unique ID exactly as they appear in a database directory entry.  */
+
+static bool
+read_binary_record (FILE* f, unsigned long& lineno,
+		    Record& rec, RecKey& key, UniqueIDs& uids) {
+  unsigned char header[8];
+
+  size_t n = fread (header, 1, sizeof header, f);
+  if (n == 0)
+    return false;
+  else if (n != sizeof header)
+    throw "truncated record header";
+
+  const unsigned char* s = header;
+  unsigned long size = get_long (s);
+  unsigned char attributes = get_byte (s);
+  unsigned long uid = get_byte (s);
+  uid = (uid << 16) | get_word (s);
+
+  clear_record_attributes (rec);
+  rec.category = attributes & 0x0f;
+  rec.secret = (attributes & 0x10) != 0;
+  rec.busy = (attributes & 0x20) != 0;
+  rec.dirty = (attributes & 0x40) != 0;
+  rec.deletable = (attributes & 0x80) != 0;
+  key = uids.use (uid);
+
+  Datablock block (size);
+  if (fread (block.writable_contents(), 1, size, f) != size)
+    throw "truncated record";
+  static_cast<Datablock&>(rec) = block;
+
+  lineno++;
+  return true;
+  }
+
+
+static void
+write_csv_record (FILE* f, RecKey key, const Record& rec) {
+  static std::vector<std::string> fields;
+  split_fields (rec, fields);
+
+  std::vector<std::string>::size_type nfield = 0;
+  std::vector<column_kind>::size_type i;
+  for (i = 0; i < columns.size() || nfield < fields.size(); i++) {
+    if (i > 0)
+      putc (',', f);
+
+    switch ((i < columns.size())? columns[i] : COL_FIELD) {
+    case COL_UID:
+      fprintf (f, "%lu", key);
+      break;
+
+    case COL_CATEGORY: {
+      const char* name = category_names? categories.name (rec.category) : NULL;
+      if (name)
+	write_csv_field (f, name);
+      else
+	fprintf (f, "%u", rec.category);
+      }
+      break;
+
+    case COL_ATTRIBUTES:
+      write_csv_field (f, record_attributes_string (rec));
+      break;
+
+    case COL_FIELD:
+      if (nfield < fields.size())
+	write_csv_field (f, fields[nfield++]);
+      break;
+
+    case COL_SKIP:
+      break;
+      }
+    }
+
+  putc ('\n', f);
+  }
+
+static void
+write_jsonl_record (FILE* f, RecKey key, const Record& rec) {
+  fprintf (f, "{\"uid\":%lu,\"category\":", key);
+
+  const char* name = category_names? categories.name (rec.category) : NULL;
+  if (name)
+    write_json_string (f, name);
+  else
+    fprintf (f, "%u", rec.category);
+
+  std::string attributes = record_attributes_string (rec);
+  if (!attributes.empty()) {
+    fputs (",\"attributes\":", f);
+    write_json_string (f, attributes);
+    }
+
+  fputs (",\"data\":", f);
+  write_json_string (f, std::string ((const char*) rec.contents(), rec.size()));
+  fputs ("}\n", f);
+  }
+
+static void
+write_binary_record (FILE* f, RecKey key, const Record& rec) {
+  unsigned char header[8];
+  unsigned char* s = header;
+
+  unsigned char attributes = rec.category & 0x0f;
+  if (rec.secret)	attributes |= 0x10;
+  if (rec.busy)		attributes |= 0x20;
+  if (rec.dirty)	attributes |= 0x40;
+  if (rec.deletable)	attributes |= 0x80;
+
+  put_long (s, rec.size());
+  put_byte (s, attributes);
+  put_byte (s, key >> 16);
+  put_word (s, key);
+
+  fwrite (header, 1, sizeof header, f);
+  fwrite (rec.contents(), 1, rec.size(), f);
+  }
+
+
+static Datablock
+slurp_file_as_datablock (const char* fname) {
+  long length;
+  void* buffer = slurp_file (fname, "rb", &length);
+  if (buffer == NULL)
+    throw "can't read file";
+
+  Datablock block (length);
+  memcpy (block.writable_contents(), buffer, length);
+  free (buffer);
+  return block;
+  }
+
+static void
+write_datablock_file (const char* fname, const Datablock& block) {
+  FILE* f = fopen (fname, "wb");
+  if (f == NULL
+      || fwrite (block.contents(), 1, block.size(), f) != size_t (block.size()))
+    error ("can't write to '%s': @P", fname);
+  if (f)
+    fclose (f);
+  }
+
+
+static void
+import (RecordDatabaseWriter& db, const char* fname, FILE* f) {
+  bool (*read_record) (FILE*, unsigned long&, Record&, RecKey&, UniqueIDs&)
+    = (format == DF_JSONL)? read_jsonl_record
+    : (format == DF_BINARY)? read_binary_record
+    : read_csv_record;
+
+  UniqueIDs uids;
+  unsigned long lineno = 0, start = 0;
+  Record rec;
+  RecKey key;
+
+  if (format == DF_CSV && csv_header) {
+    std::vector<std::string> row;
+    read_csv_row (f, row, lineno);
+    }
+
+  try {
+    while (start = lineno + 1, read_record (f, lineno, rec, key, uids))
+      db.add (key, rec);
+    } catch (const char* message) {
+    error ((format == DF_BINARY)? "[%s] record %lu: %s" : "[%s:%lu] %s",
+	   fname, start, message);
+    }
+
+  if (ferror (f))
+    error ("[%s] read error: @P", fname);
+
+  db.uidseed = uids.seed();
+  db.appinfo = categories.update (db.appinfo);
+  }
+
+static void
+write_database (const char* fname, const PalmOSDatabase& db) {
+  FILE* f = fopen (fname, "wb");
+  if (f) {
+    if (db.write (f))
+      fclose (f);
+    else {
+      error ("error writing to '%s': @P", fname);
+      fclose (f);
+      remove (fname);
+      }
+    }
+  else
+    error ("can't write to '%s': @P", fname);
+  }
+
+
+/* A collection of more records than fit in one database (or than the
+   shard size) is split into shards of consecutive records, which are
+   written to FNAME-1.pdb, FNAME-2.pdb, etc, and named NAME-1, NAME-2,
+   etc.  FNAME itself becomes a master database describing the shards, in
+   the format given in libc/m68k/pdbindex.h:  its AppInfo block is a
+   header, and each record describes one shard and gives its first key.  */
+
+static const unsigned long shard_info_signature = 0x73687264ul;  // 'shrd'
+static const unsigned int shard_info_version = 1;
+static const unsigned int shard_key_none = 0xffff;
+
+static void
+write_shards (const char* fname, RecordDatabaseWriter& db) {
+  unsigned long total = db.count();
+  unsigned long nshards = (total + shard_size - 1) / shard_size;
+  unsigned int width = key_index_width? key_index_width : 8;
+
+  RecordDatabase master;
+  static_cast<DatabaseHeader&>(master) = db;
+
+  std::string base (fname);
+  std::string::size_type dot = base.rfind ('.');
+  std::string::size_type slash = base.find_last_of ("/\\");
+  std::string ext;
+  if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+    ext = base.substr (dot), base.erase (dot);
+
+  char name[32];
+  strncpy (name, db.name, 32);
+  name[31] = '\0';
+
+  Datablock sortinfo = db.sortinfo;
+
+  for (unsigned long i = 0; i < nshards && nerrors == 0; i++) {
+    unsigned long first = i * shard_size;
+    unsigned long n = std::min (shard_size, total - first);
+    db.select (first, n);
+
+    char suffix[24];
+    sprintf (suffix, "-%lu", i + 1);
+    int len = std::min (strlen (name), 31 - strlen (suffix));
+    sprintf (db.name, "%.*s%s", len, name, suffix);
+
+    if (sort_key && dictionary_size == 0)
+      db.sortinfo = db.key_index (width, key_index_interval);
+    else
+      db.sortinfo = sortinfo;
+
+    write_database ((base + suffix + ext).c_str(), db);
+
+    std::string key, lastkey;
+    if (sort_key) {
+      key = db.sort_key_of (first);
+      lastkey = db.sort_key_of (first + n - 1);
+      }
+
+    Record rec;
+    clear_record_attributes (rec);
+    static_cast<Datablock&>(rec)
+      = Datablock (10 + 32 + key.size() + lastkey.size());
+    unsigned char* s = rec.writable_contents();
+    put_long (s, first);
+    put_word (s, n);
+    put_word (s, key.size());
+    put_word (s, lastkey.size());
+    memset (s, 0, 32);
+    strncpy ((char*) s, db.name, 32), s += 32;
+    memcpy (s, key.data(), key.size()), s += key.size();
+    memcpy (s, lastkey.data(), lastkey.size());
+    master[i + 1] = rec;
+    }
+
+  db.select_all ();
+
+  Datablock info (20);
+  unsigned char* s = info.writable_contents();
+  put_long (s, shard_info_signature);
+  put_word (s, shard_info_version);
+  put_word (s, nshards);
+  put_long (s, total);
+  put_word (s, sort_key? sort_key->kind : shard_key_none);
+  put_word (s, sort_key? sort_key->param : 0);
+  put_word (s, sort_key? sort_key->length : 0);
+  put_word (s, 0);
+  master.appinfo = info;
+  master.uidseed = nshards + 1;
+
+  if (nerrors == 0)
+    write_database (fname, master);
+  }
+
+static void
+export_records (RecordDatabaseReader& db, FILE* f) {
+  void (*write_record) (FILE*, RecKey, const Record&)
+    = (format == DF_JSONL)? write_jsonl_record
+    : (format == DF_BINARY)? write_binary_record
+    : write_csv_record;
+
+  RecordCodec* codec = NULL;
+  if (RecordCodec::recognizes (db.appinfo))
+    codec = new RecordCodec (db.appinfo);
+
+  Record rec;
+  RecKey key;
+
+  try {
+    while (db.next (key, rec)) {
+      if (codec)
+	static_cast<Datablock&>(rec) = codec->decompress (rec);
+      write_record (f, key, rec);
+      }
+    } catch (...) {
+    delete codec;
+    throw;
+    }
+
+  delete codec;
+  }
+
+
+int
+main (int argc, char** argv) {
+  bool work_desired = true;
+  int c;
+
+  const char* output_fname = NULL;
+  const char* appinfo_fname = NULL;
+  const char* sortinfo_fname = NULL;
+  DatabaseHeader header;
+  bool backup = false;
+
+  set_progname (argv[0]);
+
+  init_database_header (&header);
+  strncpy (header.type, "DATA", 4);
+  parse_columns ("uid,category,attributes");
+
+  while ((c = getopt_long (argc, argv, shortopts, longopts, NULL)) >= 0)
+    switch (c) {
+    case 'o':
+      output_fname = optarg;
+      break;
+
+    case 'f':
+      if (strcmp (optarg, "csv") == 0)		format = DF_CSV;
+      else if (strcmp (optarg, "jsonl") == 0)	format = DF_JSONL;
+      else if (strcmp (optarg, "binary") == 0)	format = DF_BINARY;
+      else
+	error ("unknown data file format '%s'", optarg);
+      break;
+
+    case 'k':
+      parse_columns (optarg);
+      break;
+
+    case 'u':
+      uid_base = strtoul (optarg, NULL, 0);
+      break;
+
+    case 'S':
+      delete sort_key;
+      if ((sort_key = parse_sort_key (optarg)) == NULL)
+	error ("invalid sort key '%s'", optarg);
+      break;
+
+    case 'x':
+      key_index_width = optarg? strtoul (optarg, NULL, 0) : 8;
+      if (key_index_width == 0)
+	error ("invalid key index width '%s'", optarg);
+      break;
+
+    case 'z':
+      dictionary_size = optarg? strtoul (optarg, NULL, 0) : 4096;
+      if (dictionary_size == 0 || dictionary_size > 60000)
+	error ("dictionary size must be between 1 and 60000");
+      break;
+
+    case 'a':
+      appinfo_fname = optarg;
+      break;
+
+    case 's':
+      sortinfo_fname = optarg;
+      break;
+
+    case 't':
+      strncpy (header.type, optarg, 4);
+      break;
+
+    case 'c':
+      strncpy (header.creator, optarg, 4);
+      break;
+
+    case 'n':
+      strncpy (header.name, optarg, 32);
+      break;
+
+    case 'm':
+      header.modnum = strtoul (optarg, NULL, 0);
+      break;
+
+    case 'v':
+      header.version = strtoul (optarg, NULL, 0);
+      break;
+
+    case OPTION_HEADER:
+      csv_header = true;
+      break;
+
+    case OPTION_CATEGORY_NAMES:
+      category_names = true;
+      break;
+
+    case OPTION_BACKUP:
+      backup = true;
+      break;
+
+    case OPTION_INDEX_INTERVAL:
+      key_index_interval = strtoul (optarg, NULL, 0);
+      break;
+
+    case OPTION_SHARD_SIZE:
+      shard_size = strtoul (optarg, NULL, 0);
+      if (shard_size == 0 || shard_size > 0xffff)
+	error ("shard size must be between 1 and 65535");
+      break;
+
+    case OPTION_HELP:
+      usage();
+      work_desired = false;
+      break;
+
+    case OPTION_VERSION:
+      print_version ("pdb-tool", "Jp");
+      work_desired = false;
+      break;
+      }
+
+  if (!work_desired)
+    return EXIT_SUCCESS;
+
+  const char* command = (optind < argc)? argv[optind++] : "";
+
+  if (nerrors)
+    return EXIT_FAILURE;
+
+  if (key_index_width && sort_key == NULL)
+    error ("a key index requires a sort key");
+  if (key_index_width && sortinfo_fname)
+    error ("a key index can't be combined with a SortInfo block");
+  if (dictionary_size && key_index_width)
+    error ("a key index can't be used with compressed records");
+  if (dictionary_size && appinfo_fname && strcmp (command, "import") == 0)
+    error ("compressed records need the AppInfo block for their dictionary");
+
+  if (nerrors)
+    return EXIT_FAILURE;
+
+  if (strcmp (command, "import") == 0 && output_fname && argc - optind <= 1) {
+    const char* input_fname = (optind < argc)? argv[optind] : "-";
+    FILE* in = (strcmp (input_fname, "-") == 0)? stdin
+	     : fopen (input_fname, (format == DF_BINARY)? "rb" : "r");
+    if (in == NULL) {
+      error ("can't open '%s': @P", input_fname);
+      return EXIT_FAILURE;
+      }
+
+    try {
+      RecordDatabaseWriter db;
+      static_cast<DatabaseHeader&>(db) = header;
+      db.backup = backup;
+
+      time_t now = time (NULL);
+      struct tm* now_tm = localtime (&now);
+      db.created = db.modified = *now_tm;
+
+      if (appinfo_fname)  db.appinfo = slurp_file_as_datablock (appinfo_fname);
+      if (sortinfo_fname)
+	db.sortinfo = slurp_file_as_datablock (sortinfo_fname);
+      categories.load (db.appinfo);
+      if (sort_key)
+	db.sort_by (*sort_key);
+
+      import (db, input_fname, in);
+
+      if (sort_key)
+	db.sort ();
+      if (dictionary_size && nerrors == 0) {
+	if (db.appinfo.size() > 0)
+	  throw "compressed records need the AppInfo block for their "
+		"dictionary, so categories can't be named";
+	db.appinfo = db.compress (dictionary_size);
+	}
+      if (key_index_width && db.count() <= shard_size)
+	db.sortinfo = db.key_index (key_index_width, key_index_interval);
+
+      if (nerrors == 0 && db.name[0] == '\0')
+	warning ("creating '%s' without a name", output_fname);
+
+      if (nerrors == 0 && db.count() > shard_size)
+	write_shards (output_fname, db);
+      else if (nerrors == 0)
+	write_database (output_fname, db);
+      } catch (const char* message) {
+      error ("%s", message);
+      }
+
+    if (in != stdin)
+      fclose (in);
+    }
+  else if (strcmp (command, "export") == 0 && argc - optind == 1) {
+    const char* input_fname = argv[optind];
+    FILE* in = fopen (input_fname, "rb");
+    if (in == NULL) {
+      error ("can't open '%s': @P", input_fname);
+      return EXIT_FAILURE;
+      }
+
+    FILE* out = stdout;
+    if (output_fname && (out = fopen (output_fname, "wb")) == NULL) {
+      error ("can't write to '%s': @P", output_fname);
+      return EXIT_FAILURE;
+      }
+
+    try {
+      RecordDatabaseReader db (in);
+      categories.load (db.appinfo);
+
+      if (appinfo_fname)  write_datablock_file (appinfo_fname, db.appinfo);
+      if (sortinfo_fname)  write_datablock_file (sortinfo_fname, db.sortinfo);
+
+      export_records (db, out);
+      } catch (const char* message) {
+      error ("[%s] %s", input_fname, message);
+      }
+
+    if (ferror (out) || (out != stdout && fclose (out) != 0))
+      error ("error writing to '%s': @P",
+	     output_fname? output_fname : "standard output");
+    fclose (in);
+    }
+  else {
+    usage();
+    nerrors++;
+    }
+
+  return (nerrors == 0)? EXIT_SUCCESS : EXIT_FAILURE;
+  }
@@ -275,6 +275,9 @@ ResourceDatabase::directory_size (unsigned int n) {
 
 bool
 ResourceDatabase::write_directory (FILE* f, unsigned long& offset) const {
+  if (size() > 0xffff)
+    return false;
+
   { unsigned char buffer[2];
     unsigned char* s = buffer;
     put_word (s, size());
@@ -312,6 +315,25 @@ static const unsigned char busy_mask	  = 0x20;
 static const unsigned char dirty_mask	  = 0x40;
 static const unsigned char deletable_mask = 0x80;
 
+static unsigned char
+attributes_of_record (const Record& rec) {
+  unsigned char attributes = rec.category & category_mask;
+  if (rec.deletable)	attributes |= deletable_mask;
+  if (rec.dirty)	attributes |= dirty_mask;
+  if (rec.busy)		attributes |= busy_mask;
+  if (rec.secret)	attributes |= secret_mask;
+  return attributes;
+  }
+
+static void
+set_record_attributes (Record& rec, unsigned char attributes) {
+  rec.category  =  attributes & category_mask;
+  rec.deletable = (attributes & deletable_mask) != 0;
+  rec.dirty	= (attributes & dirty_mask) != 0;
+  rec.busy	= (attributes & busy_mask) != 0;
+  rec.secret	= (attributes & secret_mask) != 0;
+  }
+
 RecordDatabase::RecordDatabase() : PalmOSDatabase (false) {
   }
 
@@ -335,12 +357,8 @@ RecordDatabase::RecordDatabase (const Datablock& block)
       throw "corrupt 5";
 
     Record rec;
-    static_cast<Datablock>(rec) = block (entry, entrylim - entry);
-    rec.category  =  attributes & category_mask;
-    rec.deletable = (attributes & deletable_mask) != 0;
-    rec.dirty	  = (attributes & dirty_mask) != 0;
-    rec.busy	  = (attributes & busy_mask) != 0;
-    rec.secret	  = (attributes & secret_mask) != 0;
+    static_cast<Datablock&>(rec) = block (entry, entrylim - entry);
+    set_record_attributes (rec, attributes);
 
     insert (RecordMap::value_type (key, rec));
     entrylim = entry;
@@ -359,6 +377,9 @@ RecordDatabase::directory_size (unsigned int n) {
 
 bool
 RecordDatabase::write_directory (FILE* f, unsigned long& offset) const {
+  if (size() > 0xffff)
+    return false;
+
   { unsigned char buffer[2];
     unsigned char* s = buffer;
     put_word (s, size());
@@ -369,11 +390,7 @@ RecordDatabase::write_directory (FILE* f, unsigned long& offset) const {
     unsigned char buffer[8];
     unsigned char* s = buffer;
 
-    unsigned char attributes = (*it).second.category & category_mask;
-    if ((*it).second.deletable)	attributes |= deletable_mask;
-    if ((*it).second.dirty)	attributes |= dirty_mask;
-    if ((*it).second.busy)	attributes |= busy_mask;
-    if ((*it).second.secret)	attributes |= secret_mask;
+    unsigned char attributes = attributes_of_record ((*it).second);
 
     put_long (s, offset);
     put_long (s, (*it).first);
@@ -393,3 +410,418 @@ RecordDatabase::write_data (FILE* f) const {
 
   return true;
   }
+
+
+
+RecordStream::RecordStream() : PalmOSDatabase (false), all (true) {
+  }
+
+RecordStream::RecordStream (const Datablock& block)
+  : PalmOSDatabase (false, block), prefix (block), all (true) {
+  }
+
+RecordStream::~RecordStream() {
+  }
+
+bool
+RecordStream::write_directory (FILE* f, unsigned long& offset) const {
+  if (selection_end() - selection_begin() > 0xffff)
+    return false;
+
+  { unsigned char buffer[2];
+    unsigned char* s = buffer;
+    put_word (s, selection_end() - selection_begin());
+    if (fwrite (buffer, 1, sizeof buffer, f) != sizeof buffer)  return false;
+    }
+
+  for (std::vector<entry>::const_iterator it = dir.begin() + selection_begin();
+       it != dir.begin() + selection_end();
+       ++it) {
+    unsigned char buffer[8];
+    unsigned char* s = buffer;
+    put_long (s, offset);
+    put_long (s, (*it).key);
+    s -= 4;
+    put_byte (s, (*it).attributes);
+    if (fwrite (buffer, 1, sizeof buffer, f) != sizeof buffer)  return false;
+    offset += (*it).size;
+    }
+
+  return true;
+  }
+
+// Copies LEN bytes from the current position in FROM to TO.
+
+static bool
+copy_stream (FILE* to, FILE* from, unsigned long len) {
+  char buffer[8192];
+
+  while (len > 0) {
+    size_t n = (len < sizeof buffer)? len : sizeof buffer;
+    if (fread (buffer, 1, n, from) != n || fwrite (buffer, 1, n, to) != n)
+      return false;
+    len -= n;
+    }
+
+  return true;
+  }
+
+
+std::string
+SortKey::extract (const Datablock& block) const {
+  const char* s = (const char*) block.contents();
+  const char* lim = s + block.size();
+
+  if (kind == BYTES) {
+    std::string key (length, '\0');
+    if (param < (unsigned long) block.size())
+      key.replace (0, std::min<long> (length, lim - (s + param)),
+		   s + param, std::min<long> (length, lim - (s + param)));
+    return key;
+    }
+
+  if (kind == STRING)
+    s += std::min<long> (param, block.size());
+  else
+    for (unsigned int i = 0; i < param && s < lim; i++) {
+      const char* nul = (const char*) memchr (s, '\0', lim - s);
+      s = nul? nul + 1 : lim;
+      }
+
+  const char* end = (const char*) memchr (s, '\0', lim - s);
+  return std::string (s, end? end : lim);
+  }
+
+
+RecordDatabaseWriter::RecordDatabaseWriter()
+  : spool (tmpfile ()), spool_size (0), sort_key (NULL) {
+  if (spool == NULL)
+    throw "can't create temporary file";
+  }
+
+RecordDatabaseWriter::~RecordDatabaseWriter() {
+  fclose (spool);
+  delete sort_key;
+  }
+
+void
+RecordDatabaseWriter::add (RecKey key, const Record& rec) {
+  if (!write_datablock (spool, rec))
+    throw "error writing temporary file";
+
+  entry e;
+  e.key = key & 0xfffffful;
+  e.attributes = attributes_of_record (rec);
+  e.size = rec.size();
+  dir.push_back (e);
+
+  spooled_record sp;
+  sp.offset = spool_size;
+  if (sort_key)
+    sp.key = sort_key->extract (rec);
+  spooled.push_back (sp);
+
+  spool_size += rec.size();
+  }
+
+void
+RecordDatabaseWriter::select (unsigned long first0, unsigned long n0) {
+  if (first0 > dir.size() || n0 > dir.size() - first0)
+    throw "selected records out of range";
+
+  all = false;
+  first = first0;
+  n = n0;
+  }
+
+void
+RecordDatabaseWriter::select_all () {
+  all = true;
+  }
+
+void
+RecordDatabaseWriter::sort_by (const SortKey& key) {
+  if (!dir.empty())
+    throw "sort key must be given before any records are added";
+
+  delete sort_key;
+  sort_key = new SortKey (key);
+  }
+
+struct key_order {
+  key_order (const std::vector<std::string>& keys0) : keys (keys0) {}
+  bool operator() (unsigned int a, unsigned int b) const {
+    return keys[a] < keys[b];
+    }
+  const std::vector<std::string>& keys;
+  };
+
+// Sorts the records added so far by their keys, keeping records with equal
+// keys in the order in which they were added.
+
+void
+RecordDatabaseWriter::sort () {
+  if (sort_key == NULL)
+    throw "no sort key has been given";
+
+  std::vector<std::string> keys (spooled.size());
+  std::vector<unsigned int> order (spooled.size());
+  for (unsigned int i = 0; i < spooled.size(); i++) {
+    keys[i].swap (spooled[i].key);
+    order[i] = i;
+    }
+
+  std::stable_sort (order.begin(), order.end(), key_order (keys));
+
+  std::vector<entry> sorted_dir (dir.size());
+  std::vector<spooled_record> sorted_spooled (spooled.size());
+  for (unsigned int i = 0; i < order.size(); i++) {
+    sorted_dir[i] = dir[order[i]];
+    sorted_spooled[i].offset = spooled[order[i]].offset;
+    sorted_spooled[i].key.swap (keys[order[i]]);
+    }
+
+  dir.swap (sorted_dir);
+  spooled.swap (sorted_spooled);
+  }
+
+// The key index format, which is described in libc/m68k/pdbindex.h, is a
+// header followed by the first WIDTH bytes of every INTERVAL'th selected
+// record's key.  By default INTERVAL is chosen to keep the index within one
+// chunk.
+
+static const unsigned long key_index_signature = 0x6b696478ul;  // 'kidx'
+static const unsigned int key_index_version = 1;
+static const long key_index_header_size = 20;
+static const long key_index_max_size = 64000;
+
+Datablock
+RecordDatabaseWriter::key_index (unsigned int width,
+				 unsigned int interval) const {
+  if (sort_key == NULL)
+    throw "no sort key has been given";
+  if (width == 0)
+    throw "key index width must be positive";
+
+  unsigned long base = selection_begin();
+  unsigned long n = selection_end() - base;
+
+  if (interval == 0) {
+    unsigned long max_entries = (key_index_max_size - key_index_header_size)
+				/ width;
+    interval = (n + max_entries - 1) / max_entries;
+    if (interval == 0)  interval = 1;
+    }
+
+  unsigned long entries = (n + interval - 1) / interval;
+  long size = key_index_header_size + entries * width;
+  if (size > key_index_max_size)
+    throw "key index is too large (use a larger interval or smaller width)";
+
+  Datablock block (size);
+  unsigned char* s = block.writable_contents();
+
+  put_long (s, key_index_signature);
+  put_word (s, key_index_version);
+  put_word (s, sort_key->kind);
+  put_word (s, sort_key->param);
+  put_word (s, sort_key->length);
+  put_word (s, width);
+  put_word (s, interval);
+  put_word (s, entries);
+  put_word (s, n);
+
+  for (unsigned long i = 0; i < n; i += interval) {
+    const std::string& key = spooled[base + i].key;
+    unsigned long len = std::min<unsigned long> (key.size(), width);
+    memcpy (s, key.data(), len);
+    memset (s + len, 0, width - len);
+    s += width;
+    }
+
+  return block;
+  }
+
+Datablock
+RecordDatabaseWriter::read_spooled (size_type i) const {
+  Datablock block (dir[i].size);
+  if (fflush (spool) != 0
+      || fseek (spool, spooled[i].offset, SEEK_SET) != 0
+      || fread (block.writable_contents(), 1, dir[i].size, spool)
+	   != dir[i].size
+      || fseek (spool, 0, SEEK_END) != 0)
+    throw "error reading temporary file";
+
+  return block;
+  }
+
+// Up to this much of the records is used to train the dictionary, taking
+// evenly spaced records when there is more.
+static const unsigned long codec_training_size = 8ul << 20;
+
+Datablock
+RecordDatabaseWriter::compress (unsigned long dict_size) {
+  std::vector<Datablock> samples;
+  unsigned long stride = spool_size / codec_training_size + 1;
+  for (size_type i = 0; i < dir.size(); i += stride)
+    samples.push_back (read_spooled (i));
+
+  RecordCodec codec (RecordCodec::train (samples, dict_size));
+  samples.clear();
+
+  FILE* packed = tmpfile ();
+  if (packed == NULL)
+    throw "can't create temporary file";
+
+  unsigned long packed_size = 0;
+  for (size_type i = 0; i < dir.size(); i++) {
+    Datablock block = codec.compress (read_spooled (i));
+    if (!write_datablock (packed, block)) {
+      fclose (packed);
+      throw "error writing temporary file";
+      }
+
+    dir[i].size = block.size();
+    spooled[i].offset = packed_size;
+    packed_size += block.size();
+    }
+
+  fclose (spool);
+  spool = packed;
+  spool_size = packed_size;
+
+  return codec.info();
+  }
+
+bool
+RecordDatabaseWriter::write_data (FILE* f) const {
+  if (fflush (spool) != 0)
+    return false;
+
+  unsigned long pos = spool_size;
+  for (size_type i = selection_begin(); i < selection_end(); i++) {
+    if (spooled[i].offset != pos
+	&& fseek (spool, spooled[i].offset, SEEK_SET) != 0)
+      return false;
+
+    if (!copy_stream (f, spool, dir[i].size))
+      return false;
+
+    pos = spooled[i].offset + dir[i].size;
+    }
+
+  return fseek (spool, 0, SEEK_END) == 0;
+  }
+
+
+// Reads everything before the first record: the header, the directory,
+// and the gap, AppInfo, and SortInfo blocks.
+
+Datablock
+RecordDatabaseReader::read_prefix (FILE* f) {
+  unsigned char buffer[header_size + 2 + 8];
+
+  if (fseek (f, 0, SEEK_SET) != 0)
+    throw "can't seek in database file";
+
+  size_t n = fread (buffer, 1, sizeof buffer, f);
+  if (n < header_size + 2)
+    throw "database header (or record count) is truncated";
+
+  const unsigned char* s = buffer + header_size;
+  unsigned int nrecs = get_word (s);
+
+  long entrystart = header_size + 2 + 8 * nrecs;
+  long prefix_size;
+  if (nrecs > 0) {
+    if (n < sizeof buffer)
+      throw "corrupt 5";
+    prefix_size = get_long (s);
+    if (prefix_size < entrystart)
+      throw "corrupt 5";
+    }
+  else {
+    if (fseek (f, 0, SEEK_END) != 0)
+      throw "can't seek in database file";
+    prefix_size = ftell (f);
+    }
+
+  Datablock block (prefix_size);
+  if (fseek (f, 0, SEEK_SET) != 0
+      || fread (block.writable_contents(), 1, prefix_size, f)
+	   != size_t (prefix_size))
+    throw "database is truncated";
+
+  return block;
+  }
+
+RecordDatabaseReader::RecordDatabaseReader (FILE* f)
+  : RecordStream (read_prefix (f)), file (f), index (0) {
+  const Datablock& block = prefix;
+
+  const unsigned char* s = block.contents() + header_size;
+  unsigned int nrecs = get_word (s);
+
+  long entrystart = header_size + 2 + 8 * nrecs;
+
+  if (fseek (f, 0, SEEK_END) != 0)
+    throw "can't seek in database file";
+  unsigned long filesize = ftell (f);
+
+  dir.resize (nrecs);
+  unsigned long entrylim = filesize;
+  const unsigned char* d = block.contents() + entrystart;
+  for (unsigned int i = nrecs; i-- > 0; ) {
+    s = d -= 8;
+    unsigned long entry = get_long (s);
+    dir[i].key = get_long (s) & 0xfffffful;
+    s -= 4;
+    dir[i].attributes = get_byte (s);
+
+    if (entry < (unsigned long) entrystart || entry > entrylim)
+      throw "corrupt 5";
+
+    dir[i].size = entrylim - entry;
+    entrylim = entry;
+    }
+
+  read_header (block, entrystart, entrylim);
+  prefix = Datablock();
+
+  data_offset = offset = entrylim;
+  if (fseek (f, offset, SEEK_SET) != 0)
+    throw "can't seek in database file";
+  }
+
+RecordDatabaseReader::~RecordDatabaseReader() {
+  }
+
+bool
+RecordDatabaseReader::next (RecKey& key, Record& rec) {
+  if (index >= dir.size())
+    return false;
+
+  const entry& e = dir[index++];
+  Datablock block (e.size);
+  if (fread (block.writable_contents(), 1, e.size, file) != e.size)
+    throw "database is truncated";
+  offset += e.size;
+
+  key = e.key;
+  static_cast<Datablock&>(rec) = block;
+  set_record_attributes (rec, e.attributes);
+  return true;
+  }
+
+bool
+RecordDatabaseReader::write_data (FILE* f) const {
+  unsigned long len = 0;
+  for (std::vector<entry>::const_iterator it = dir.begin();
+       it != dir.end();
+       ++it)
+    len += (*it).size;
+
+  return fseek (file, data_offset, SEEK_SET) == 0
+      && copy_stream (f, file, len)
+      && fseek (file, offset, SEEK_SET) == 0;
+  }
@@ -12,6 +12,8 @@
 #define PFD_HPP
 
 #include <map>
+#include <string>
+#include <vector>
 
 #include <string.h>
 #include <stdio.h>
@@ -122,4 +124,154 @@ private:
   virtual bool write_data (FILE* f) const;
   };
 
+
+/* These two classes give sequential access to record databases too large
+   to want to hold in memory all at once: each keeps only the directory
+   entries in memory, and record contents pass through one at a time.  */
+
+class RecordStream: public PalmOSDatabase {
+public:
+  virtual ~RecordStream();
+  unsigned long count() const { return dir.size(); }
+
+protected:
+  RecordStream();
+  RecordStream (const Datablock& block);
+
+  struct entry {
+    RecKey key;
+    unsigned char attributes;
+    unsigned long size;
+    };
+
+  std::vector<entry> dir;
+
+  // The header and directory the stream was read from, if any.
+  Datablock prefix;
+
+  // The range of records that write() writes, normally all of them.
+  typedef std::vector<entry>::size_type size_type;
+  size_type selection_begin() const { return all ? 0 : first; }
+  size_type selection_end() const { return all ? dir.size() : first + n; }
+  bool all;
+  size_type first, n;
+
+private:
+  virtual unsigned long directory_size() const {
+    return 2 + 8 * (selection_end() - selection_begin());
+    }
+  virtual bool write_directory (FILE* f, unsigned long& off) const;
+  };
+
+/* A record sort key:  LENGTH bytes at offset PARAM (zero-padded if the
+   record is shorter), the NUL-terminated string at offset PARAM, or the
+   PARAM'th NUL-terminated string field.  Keys compare as unsigned bytes.  */
+
+struct SortKey {
+  enum kind { BYTES, STRING, FIELD };
+
+  SortKey (enum kind k, unsigned int param0, unsigned int length0 = 0)
+    : kind (k), param (param0), length (length0) {}
+
+  std::string extract (const Datablock& block) const;
+
+  enum kind kind;
+  unsigned int param, length;
+  };
+
+/* A static-dictionary LZ codec for record contents, in the format given in
+   libc/m68k/pdbcodec.h.  The dictionary, trained by train() on samples of
+   a database's own records, is stored as the database's AppInfo block,
+   and each record is coded as literals and references back into the
+   dictionary and the record itself.  */
+
+class RecordCodec {
+public:
+  RecordCodec (const std::string& dictionary);
+  RecordCodec (const Datablock& info);
+
+  static bool recognizes (const Datablock& info);
+  static std::string train (const std::vector<Datablock>& samples,
+			    unsigned long size);
+
+  Datablock info () const;
+  Datablock compress (const Datablock& block);
+  Datablock decompress (const Datablock& block) const;
+
+private:
+  void init_chains ();
+
+  std::string dict;
+  std::vector<long> dict_head, dict_prev;
+
+  // Scratch space for compress(), reused from one record to the next.
+  std::vector<unsigned char> window;
+  std::vector<long> head, prev;
+  std::vector<unsigned long> head_stamp;
+  unsigned long stamp;
+  };
+
+/* Records are added in the order in which they are to appear in the
+   database, unless a sort key is given first with sort_by(), and their
+   contents are spooled to a temporary file until write() is called.  */
+
+class RecordDatabaseWriter: public RecordStream {
+public:
+  RecordDatabaseWriter();
+  virtual ~RecordDatabaseWriter();
+
+  void add (RecKey key, const Record& rec);
+
+  /* A database can hold at most 65535 records, so a larger collection
+     must be written out as several databases, each via select().  */
+  void select (unsigned long first, unsigned long n);
+  void select_all ();
+
+  void sort_by (const SortKey& key);
+  void sort ();
+  const std::string& sort_key_of (unsigned long i) const {
+    return spooled[i].key;
+    }
+  Datablock key_index (unsigned int width, unsigned int interval = 0) const;
+
+  /* Trains a dictionary of up to DICT_SIZE bytes on the records added so
+     far, compresses each of them with it, and returns the codec's AppInfo
+     block.  No more records should be added afterwards.  */
+  Datablock compress (unsigned long dict_size);
+
+private:
+  virtual bool write_data (FILE* f) const;
+  Datablock read_spooled (size_type i) const;
+
+  struct spooled_record {
+    unsigned long offset;
+    std::string key;
+    };
+
+  FILE* spool;
+  unsigned long spool_size;
+  std::vector<spooled_record> spooled;
+  SortKey* sort_key;
+  };
+
+/* Reads the header, AppInfo, and SortInfo blocks of the database in F,
+   which must be seekable, and then each record in turn via next().  */
+
+class RecordDatabaseReader: public RecordStream {
+public:
+  RecordDatabaseReader (FILE* f);
+  virtual ~RecordDatabaseReader();
+
+  bool next (RecKey& key, Record& rec);
+
+private:
+  static Datablock read_prefix (FILE* f);
+
+  virtual bool write_data (FILE* f) const;
+
+  FILE* file;
+  unsigned long data_offset, offset;
+  std::vector<entry>::size_type index;
+  };
+
 #endif
@@ -0,0 +1,323 @@
+/* pfdcodec.cpp: static-dictionary record compression.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#include "pfd.hpp"
+#include "pfdio.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+/* The format, which is described in libc/m68k/pdbcodec.h, is a header and
+   the dictionary as the AppInfo block, and for each record its original
+   length followed by a sequence of tokens:  a control byte C less than 0x80
+   is followed by C+1 literal bytes, while C >= 0x80 is followed by a
+   16-bit distance D and copies (C & 0x7f) + 4 bytes from D bytes back in
+   the dictionary followed by the record decoded so far.  */
+
+static const unsigned long codec_signature = 0x6c7a6463ul;  // 'lzdc'
+static const unsigned int codec_version = 1;
+static const long codec_header_size = 8;
+
+static const unsigned long max_distance = 0xffff;
+static const unsigned long max_dictionary = 60000;
+static const unsigned int min_match = 4;
+static const unsigned int max_match = min_match + 0x7f;
+static const unsigned int max_literals = 0x80;
+
+static const unsigned int hash_bits = 12;
+static const unsigned int max_chain = 48;
+
+static inline unsigned int
+hash4 (const unsigned char* s) {
+  unsigned long v = s[0] | (s[1] << 8) | (s[2] << 16)
+		    | ((unsigned long) s[3] << 24);
+  return ((v * 2654435761ul) & 0xfffffffful) >> (32 - hash_bits);
+  }
+
+
+RecordCodec::RecordCodec (const std::string& dictionary)
+  : dict (dictionary), stamp (0) {
+  if (dict.size() > max_dictionary)
+    throw "compression dictionary is too large";
+
+  init_chains ();
+  }
+
+RecordCodec::RecordCodec (const Datablock& info) : stamp (0) {
+  if (!recognizes (info))
+    throw "AppInfo block does not hold a compression dictionary";
+
+  const unsigned char* s = info.contents() + 6;
+  unsigned int len = get_word (s);
+  dict.assign ((const char*) s, len);
+
+  init_chains ();
+  }
+
+bool
+RecordCodec::recognizes (const Datablock& info) {
+  if (info.size() < codec_header_size)
+    return false;
+
+  const unsigned char* s = info.contents();
+  unsigned long signature = get_long (s);
+  unsigned int version = get_word (s);
+  unsigned int len = get_word (s);
+  return signature == codec_signature && version == codec_version
+	 && info.size() >= codec_header_size + long (len);
+  }
+
+Datablock
+RecordCodec::info () const {
+  Datablock block (codec_header_size + dict.size());
+  unsigned char* s = block.writable_contents();
+  put_long (s, codec_signature);
+  put_word (s, codec_version);
+  put_word (s, dict.size());
+  memcpy (s, dict.data(), dict.size());
+  return block;
+  }
+
+// Threads each position in the dictionary onto a hash chain of earlier
+// positions starting with the same four bytes.  Each record's positions
+// are chained onto these without disturbing them, so that the dictionary's
+// chains are built only once.
+
+void
+RecordCodec::init_chains () {
+  dict_head.assign (1 << hash_bits, -1);
+  dict_prev.assign (dict.size(), -1);
+  head.assign (1 << hash_bits, -1);
+  head_stamp.assign (1 << hash_bits, 0);
+
+  const unsigned char* d = (const unsigned char*) dict.data();
+  for (long i = 0; i + long (min_match) <= long (dict.size()); i++) {
+    unsigned int h = hash4 (d + i);
+    dict_prev[i] = dict_head[h];
+    dict_head[h] = i;
+    }
+  }
+
+static void
+flush_literals (std::vector<unsigned char>& out,
+		const unsigned char* s, unsigned long n) {
+  while (n > 0) {
+    unsigned int len = std::min<unsigned long> (n, max_literals);
+    out.push_back (len - 1);
+    out.insert (out.end(), s, s + len);
+    s += len, n -= len;
+    }
+  }
+
+Datablock
+RecordCodec::compress (const Datablock& block) {
+  unsigned long n = block.size();
+  if (n > 0xffff)
+    throw "record is too large to compress";
+
+  long dlen = dict.size();
+  window.resize (dlen + n);
+  if (dlen > 0)  memcpy (&window[0], dict.data(), dlen);
+  if (n > 0)  memcpy (&window[dlen], block.contents(), n);
+  prev.resize (n);
+
+  if (++stamp == 0) {
+    std::fill (head_stamp.begin(), head_stamp.end(), 0);
+    stamp = 1;
+    }
+
+  std::vector<unsigned char> out;
+  out.reserve (2 + n + n / max_literals + 1);
+  out.push_back (n >> 8);
+  out.push_back (n & 0xff);
+
+  const unsigned char* w = window.empty()? NULL : &window[0];
+  long end = dlen + n;
+  long pos = dlen, lit = dlen;
+
+  while (pos < end) {
+    unsigned int best_len = 0;
+    unsigned long best_dist = 0;
+    unsigned int h = 0;
+
+    if (end - pos >= long (min_match)) {
+      h = hash4 (w + pos);
+      long cand = (head_stamp[h] == stamp)? head[h] : dict_head[h];
+      unsigned int limit = std::min<long> (max_match, end - pos);
+
+      for (unsigned int steps = max_chain;
+	   cand >= 0 && (unsigned long) (pos - cand) <= max_distance
+	   && steps > 0;
+	   steps--) {
+	if (w[cand + best_len] == w[pos + best_len]) {
+	  unsigned int len = 0;
+	  while (len < limit && w[cand + len] == w[pos + len])
+	    len++;
+	  if (len > best_len) {
+	    best_len = len, best_dist = pos - cand;
+	    if (len == limit)  break;
+	    }
+	  }
+
+	cand = (cand >= dlen)? prev[cand - dlen] : dict_prev[cand];
+	}
+      }
+
+    unsigned int advance = 1;
+    if (best_len >= min_match) {
+      flush_literals (out, w + lit, pos - lit);
+      out.push_back (0x80 | (best_len - min_match));
+      out.push_back (best_dist >> 8);
+      out.push_back (best_dist & 0xff);
+      advance = best_len;
+      }
+
+    for (long stop = pos + advance; pos < stop; pos++)
+      if (end - pos >= long (min_match)) {
+	h = hash4 (w + pos);
+	prev[pos - dlen] = (head_stamp[h] == stamp)? head[h] : dict_head[h];
+	head[h] = pos;
+	head_stamp[h] = stamp;
+	}
+
+    if (best_len >= min_match)
+      lit = pos;
+    }
+
+  flush_literals (out, w + lit, pos - lit);
+
+  Datablock result (out.size());
+  memcpy (result.writable_contents(), &out[0], out.size());
+  return result;
+  }
+
+Datablock
+RecordCodec::decompress (const Datablock& block) const {
+  const unsigned char* s = block.contents();
+  const unsigned char* lim = s + block.size();
+  if (block.size() < 2)
+    throw "compressed record is truncated";
+
+  unsigned long n = get_word (s);
+  Datablock result (n);
+  unsigned char* out = result.writable_contents();
+  const unsigned char* d = (const unsigned char*) dict.data();
+  unsigned long dlen = dict.size();
+  unsigned long pos = 0;
+
+  while (s < lim) {
+    unsigned int c = *s++;
+    if (c < 0x80) {
+      unsigned int len = c + 1;
+      if (long (len) > lim - s || len > n - pos)
+	throw "corrupt compressed record";
+      memcpy (out + pos, s, len);
+      s += len, pos += len;
+      }
+    else {
+      unsigned int len = (c & 0x7f) + min_match;
+      if (lim - s < 2)
+	throw "corrupt compressed record";
+      unsigned long dist = get_word (s);
+      if (dist == 0 || dist > pos + dlen || len > n - pos)
+	throw "corrupt compressed record";
+      for (; len > 0; len--, pos++)
+	out[pos] = (dist > pos)? d[dlen - (dist - pos)] : out[pos - dist];
+      }
+    }
+
+  if (pos != n)
+    throw "corrupt compressed record";
+
+  return result;
+  }
+
+
+/* Dictionary training follows the spirit of the "cover" algorithm:  the
+   samples are divided into one epoch per dictionary segment, and from each
+   epoch the segment whose 6-byte substrings are most common across all the
+   samples is chosen.  Once chosen, a substring counts for nothing, so that
+   later segments cover other material.  */
+
+static const unsigned int dmer_size = 6;
+static const unsigned int segment_size = 32;
+static const unsigned int freq_bits = 20;
+
+static inline unsigned long
+hash_dmer (const unsigned char* s) {
+  unsigned long v = 2166136261ul;
+  for (unsigned int i = 0; i < dmer_size; i++)
+    v = ((v ^ s[i]) * 16777619ul) & 0xfffffffful;
+  return v >> (32 - freq_bits);
+  }
+
+std::string
+RecordCodec::train (const std::vector<Datablock>& samples,
+		    unsigned long size) {
+  if (size > max_dictionary)
+    size = max_dictionary;
+
+  std::vector<unsigned char> all;
+  std::vector<unsigned long> sample_end;
+  for (std::vector<Datablock>::const_iterator it = samples.begin();
+       it != samples.end();
+       ++it) {
+    all.insert (all.end(), (*it).contents(), (*it).contents() + (*it).size());
+    sample_end.push_back (all.size());
+    }
+
+  if (all.size() <= size)
+    return std::string (all.begin(), all.end());
+
+  // DMER[i] is the hash of the substring at I, or -1 if it would run past
+  // the end of its sample.
+  std::vector<long> dmer (all.size(), -1);
+  std::vector<unsigned long> freq (1ul << freq_bits, 0);
+  unsigned long start = 0;
+  for (std::vector<unsigned long>::const_iterator it = sample_end.begin();
+       it != sample_end.end();
+       ++it) {
+    for (unsigned long i = start; i + dmer_size <= *it; i++)
+      freq[dmer[i] = hash_dmer (&all[i])]++;
+    start = *it;
+    }
+
+  unsigned long nsegments = (size + segment_size - 1) / segment_size;
+  unsigned long epoch_size = all.size() / nsegments;
+  if (epoch_size < segment_size)
+    epoch_size = segment_size;
+
+  std::string dict;
+  for (unsigned long epoch = 0;
+       epoch + segment_size <= all.size() && dict.size() < size;
+       epoch += epoch_size) {
+    unsigned long lim = std::min<unsigned long> (epoch + epoch_size,
+						 all.size());
+    unsigned long span = segment_size - dmer_size + 1;
+    unsigned long score = 0, best_score = 0, best = epoch;
+
+    for (unsigned long i = epoch; i < lim; i++) {
+      if (dmer[i] >= 0)  score += freq[dmer[i]];
+      if (i >= epoch + span && dmer[i - span] >= 0)
+	score -= freq[dmer[i - span]];
+      if (i + 1 >= epoch + span && i + dmer_size <= lim
+	  && score > best_score)
+	best_score = score, best = i + 1 - span;
+      }
+
+    if (best_score == 0)
+      continue;
+
+    unsigned long len = std::min<unsigned long> (segment_size,
+						 size - dict.size());
+    dict.append ((const char*) &all[best], len);
+    for (unsigned long i = best; i < best + span; i++)
+      if (dmer[i] >= 0)  freq[dmer[i]] = 0;
+    }
+
+  return dict;
+  }
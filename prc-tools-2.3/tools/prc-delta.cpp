@@ -0,0 +1,361 @@
+/* prc-delta.cpp: describe a new version of a resource database as a patch.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "getopt.h"
+#include "utils.h"
+#include "pfd.hpp"
+#include "pfdio.hpp"
+#include "prcdelta.hpp"
+
+void
+usage () {
+  printf ("Usage: %s [options] old.prc new.prc\n", progname);
+
+  printf ("Options:\n");
+  propt ("-o FILE, --output FILE",
+	 "Write the patch to FILE (default standard output)");
+  propt ("-r, --report", "Report the patch size for each resource type");
+  }
+
+enum {
+  OPTION_HELP = 150,
+  OPTION_VERSION
+  };
+
+static const char shortopts[] = "o:r";
+
+static struct option longopts[] = {
+  { "output", required_argument, NULL, 'o' },
+  { "report", no_argument, NULL, 'r' },
+
+  { "help", no_argument, NULL, OPTION_HELP },
+  { "version", no_argument, NULL, OPTION_VERSION },
+  { NULL, no_argument, NULL, 0 }
+  };
+
+
+static Datablock
+slurp_file_as_datablock (const char* fname) {
+  long length;
+  void* buffer = slurp_file (fname, "rb", &length);
+  if (buffer == NULL)
+    throw "can't read file";
+
+  Datablock block (length);
+  memcpy (block.writable_contents(), buffer, length);
+  free (buffer);
+  return block;
+  }
+
+
+/* Matches are found by hashing every BLOCK_SIZE-byte substring of the
+   source, and rolling the same hash along the target.  Each match is
+   extended as far as it goes in both directions, so a resource that has
+   changed only in a few places becomes a few long copies.  */
+
+static const unsigned int block_size = 16;
+static const unsigned long hash_multiplier = 0x01000193ul;
+static const unsigned int max_chain = 32;
+
+static inline unsigned long
+hash_block (const unsigned char* s) {
+  unsigned long h = 0;
+  for (unsigned int i = 0; i < block_size; i++)
+    h = (h * hash_multiplier + s[i]) & 0xfffffffful;
+  return h;
+  }
+
+static void
+insert_literals (std::vector<unsigned char>& out,
+		 const unsigned char* s, unsigned long len) {
+  if (len > 0) {
+    out.push_back (OP_INSERT);
+    put_varint (out, len);
+    out.insert (out.end(), s, s + len);
+    }
+  }
+
+static void
+encode_delta (const Datablock& source, const Datablock& target,
+	      std::vector<unsigned char>& out) {
+  const unsigned char* src = source.contents();
+  const unsigned char* t = target.contents();
+  unsigned long srclen = source.size(), tlen = target.size();
+
+  unsigned long nbuckets = 1;
+  while (nbuckets < srclen)  nbuckets <<= 1;
+  std::vector<long> head (nbuckets, -1);
+  std::vector<long> next (srclen, -1);
+  for (unsigned long j = 0; j + block_size <= srclen; j++) {
+    unsigned long h = hash_block (src + j) & (nbuckets - 1);
+    next[j] = head[h];
+    head[h] = j;
+    }
+
+  unsigned long power = 1;
+  for (unsigned int k = 1; k < block_size; k++)
+    power = (power * hash_multiplier) & 0xfffffffful;
+
+  unsigned long i = 0, lit = 0, h = 0;
+  if (tlen >= block_size)
+    h = hash_block (t);
+
+  while (i + block_size <= tlen) {
+    unsigned long best_len = 0, best_from = 0, best_back = 0;
+    unsigned int steps = max_chain;
+
+    for (long cand = head[h & (nbuckets - 1)];
+	 cand >= 0 && steps > 0;
+	 cand = next[cand], steps--)
+      if (memcmp (src + cand, t + i, block_size) == 0) {
+	unsigned long len = block_size;
+	while (cand + len < srclen && i + len < tlen
+	       && src[cand + len] == t[i + len])
+	  len++;
+	unsigned long back = 0;
+	while (back < (unsigned long) cand && back < i - lit
+	       && src[cand - back - 1] == t[i - back - 1])
+	  back++;
+	if (len + back > best_len + best_back)
+	  best_len = len, best_back = back, best_from = cand;
+	}
+
+    if (best_len > 0) {
+      insert_literals (out, t + lit, i - best_back - lit);
+      out.push_back (OP_COPY);
+      put_varint (out, best_from - best_back);
+      put_varint (out, best_len + best_back);
+      i += best_len;
+      lit = i;
+      if (i + block_size <= tlen)
+	h = hash_block (t + i);
+      }
+    else {
+      if (i + block_size < tlen)
+	h = ((h - t[i] * power) * hash_multiplier + t[i + block_size])
+	    & 0xfffffffful;
+      i++;
+      }
+    }
+
+  insert_literals (out, t + lit, tlen - lit);
+  out.push_back (OP_END);
+  }
+
+
+struct type_stats {
+  type_stats () : count (0), new_bytes (0), patch_bytes (0) {}
+  unsigned long count, new_bytes, patch_bytes;
+  };
+
+typedef std::map<std::string, type_stats> Report;
+
+static void
+print_report (FILE* f, const Report& report) {
+  fprintf (f, "%-10s %6s %12s %12s %7s\n",
+	   "type", "count", "new bytes", "patch bytes", "ratio");
+
+  type_stats total;
+  for (Report::const_iterator it = report.begin(); it != report.end(); ++it) {
+    const type_stats& st = (*it).second;
+    fprintf (f, "%-10s %6lu %12lu %12lu %6.1f%%\n", (*it).first.c_str(),
+	     st.count, st.new_bytes, st.patch_bytes,
+	     st.new_bytes? 100.0 * st.patch_bytes / st.new_bytes : 0.0);
+    total.count += st.count;
+    total.new_bytes += st.new_bytes;
+    total.patch_bytes += st.patch_bytes;
+    }
+
+  fprintf (f, "%-10s %6lu %12lu %12lu %6.1f%%\n", "total",
+	   total.count, total.new_bytes, total.patch_bytes,
+	   total.new_bytes? 100.0 * total.patch_bytes / total.new_bytes : 0.0);
+  }
+
+static void
+put_key (std::vector<unsigned char>& out, const ResKey& key) {
+  out.insert (out.end(), key.type, key.type + 4);
+  out.push_back (key.id >> 8);
+  out.push_back (key.id & 0xff);
+  }
+
+/* Returns the old resource to use as the source for the new resource KEY:
+   the one with the same key if there is one, otherwise the one of the same
+   type with the nearest ID, or NULL if there is none.  */
+
+static const ResourceDatabase::value_type*
+source_for (const ResourceDatabase& old_db, const ResKey& key) {
+  ResourceDatabase::const_iterator it = old_db.lower_bound (key);
+  const ResourceDatabase::value_type* best = NULL;
+
+  if (it != old_db.end() && strncmp ((*it).first.type, key.type, 4) == 0)
+    best = &*it;
+
+  if (it != old_db.begin()) {
+    --it;
+    if (strncmp ((*it).first.type, key.type, 4) == 0
+	&& (best == NULL || best->first.id - key.id > key.id - (*it).first.id))
+      best = &*it;
+    }
+
+  return best;
+  }
+
+static void
+write_patch (FILE* f, const Datablock& old_file, const Datablock& new_file,
+	     Report& report) {
+  resource_layout old_layout = layout_of_resource_file (old_file);
+  resource_layout new_layout = layout_of_resource_file (new_file);
+  ResourceDatabase old_db (old_file);
+  ResourceDatabase new_db (new_file);
+
+  if (old_db.size() != old_layout.keys.size()
+      || new_db.size() != new_layout.keys.size())
+    throw "duplicate resources can't be handled";
+
+  std::vector<unsigned char> out;
+  out.insert (out.end(), patch_magic, patch_magic + 4);
+  out.push_back (patch_version);
+  put_varint (out, old_file.size());
+  unsigned char crcs[8];
+  unsigned char* s = crcs;
+  put_long (s, crc32_update (0, old_file.contents(), old_file.size()));
+  put_long (s, crc32_update (0, new_file.contents(), new_file.size()));
+  out.insert (out.end(), crcs, crcs + 4);
+  put_varint (out, new_file.size());
+  out.insert (out.end(), crcs + 4, crcs + 8);
+
+  out.push_back (SEG_PREFIX);
+  encode_delta (old_file (0, old_layout.prefix_size),
+		new_file (0, new_layout.prefix_size), out);
+
+  type_stats& header_stats = report["(header)"];
+  header_stats.count++;
+  header_stats.new_bytes += new_layout.prefix_size;
+  header_stats.patch_bytes += out.size();
+
+  for (std::vector<ResKey>::const_iterator it = new_layout.keys.begin();
+       it != new_layout.keys.end();
+       ++it) {
+    if (fwrite (&out[0], 1, out.size(), f) != out.size())
+      throw "error writing patch";
+    out.clear();
+
+    const ResKey& key = *it;
+    const Datablock& block = new_db[key];
+    const ResourceDatabase::value_type* source = source_for (old_db, key);
+
+    if (source && source->first.id == key.id
+	&& source->second.size() == block.size()
+	&& memcmp (source->second.contents(), block.contents(),
+		   block.size()) == 0) {
+      out.push_back (SEG_SAME);
+      put_key (out, key);
+      }
+    else if (source) {
+      out.push_back (SEG_RESOURCE);
+      put_key (out, source->first);
+      encode_delta (source->second, block, out);
+      }
+    else {
+      out.push_back (SEG_NEW);
+      encode_delta (Datablock (), block, out);
+      }
+
+    type_stats& st = report[std::string (key.type, 4)];
+    st.count++;
+    st.new_bytes += block.size();
+    st.patch_bytes += out.size();
+    }
+
+  out.push_back (SEG_END);
+  if (fwrite (&out[0], 1, out.size(), f) != out.size())
+    throw "error writing patch";
+  }
+
+
+int
+main (int argc, char** argv) {
+  bool work_desired = true;
+  bool want_report = false;
+  const char* output_fname = NULL;
+  int c;
+
+  set_progname (argv[0]);
+
+  while ((c = getopt_long (argc, argv, shortopts, longopts, NULL)) >= 0)
+    switch (c) {
+    case 'o':
+      output_fname = optarg;
+      break;
+
+    case 'r':
+      want_report = true;
+      break;
+
+    case OPTION_HELP:
+      usage();
+      work_desired = false;
+      break;
+
+    case OPTION_VERSION:
+      print_version ("prc-delta", "J");
+      work_desired = false;
+      break;
+      }
+
+  if (!work_desired)
+    return EXIT_SUCCESS;
+
+  if (argc - optind != 2) {
+    usage();
+    return EXIT_FAILURE;
+    }
+
+  FILE* out = stdout;
+  if (output_fname && (out = fopen (output_fname, "wb")) == NULL) {
+    error ("can't write to '%s': @P", output_fname);
+    return EXIT_FAILURE;
+    }
+
+  Report report;
+  const char* fname = argv[optind];
+  try {
+    Datablock old_file = slurp_file_as_datablock (fname);
+    fname = argv[optind + 1];
+    Datablock new_file = slurp_file_as_datablock (fname);
+    fname = NULL;
+    write_patch (out, old_file, new_file, report);
+    } catch (const char* message) {
+    if (fname)
+      error ("[%s] %s", fname, message);
+    else
+      error ("%s", message);
+    }
+
+  if (ferror (out) || (out != stdout && fclose (out) != 0))
+    error ("error writing to '%s': @P",
+	   output_fname? output_fname : "standard output");
+
+  if (nerrors) {
+    if (output_fname)
+      remove (output_fname);
+    return EXIT_FAILURE;
+    }
+
+  if (want_report)
+    print_report ((out == stdout)? stderr : stdout, report);
+
+  return EXIT_SUCCESS;
+  }
@@ -0,0 +1,266 @@
+/* prc-patch.cpp: rebuild a new version of a database from a prc-delta patch.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "getopt.h"
+#include "utils.h"
+#include "pfd.hpp"
+#include "pfdio.hpp"
+#include "prcdelta.hpp"
+
+void
+usage () {
+  printf ("Usage: %s [options] old.prc [patch]\n", progname);
+
+  printf ("The patch is read from standard input if it is omitted or '-'\n");
+  printf ("Options:\n");
+  propt ("-o FILE, --output FILE",
+	 "Write the new database to FILE (default standard output)");
+  }
+
+enum {
+  OPTION_HELP = 150,
+  OPTION_VERSION
+  };
+
+static const char shortopts[] = "o:";
+
+static struct option longopts[] = {
+  { "output", required_argument, NULL, 'o' },
+
+  { "help", no_argument, NULL, OPTION_HELP },
+  { "version", no_argument, NULL, OPTION_VERSION },
+  { NULL, no_argument, NULL, 0 }
+  };
+
+
+static Datablock
+slurp_file_as_datablock (const char* fname) {
+  long length;
+  void* buffer = slurp_file (fname, "rb", &length);
+  if (buffer == NULL)
+    throw "can't read file";
+
+  Datablock block (length);
+  memcpy (block.writable_contents(), buffer, length);
+  free (buffer);
+  return block;
+  }
+
+
+/* The new file is written as the patch is read, so only the old file is
+   held in memory.  Its size and CRC are accumulated as it goes and checked
+   against those recorded in the patch at the end.  */
+
+struct output {
+  output (FILE* f0) : f (f0), size (0), crc (0) {}
+
+  void write (const unsigned char* s, unsigned long len) {
+    if (fwrite (s, 1, len, f) != len)
+      throw "error writing new database";
+    crc = crc32_update (crc, s, len);
+    size += len;
+    }
+
+  FILE* f;
+  unsigned long size, crc;
+  };
+
+static unsigned long
+read_varint (FILE* patch) {
+  unsigned long v;
+  if (!get_varint (patch, v))
+    throw "patch is truncated";
+  return v;
+  }
+
+static void
+read_bytes (FILE* patch, unsigned char* s, size_t len) {
+  if (fread (s, 1, len, patch) != len)
+    throw "patch is truncated";
+  }
+
+static ResKey
+read_key (FILE* patch) {
+  unsigned char buffer[6];
+  read_bytes (patch, buffer, sizeof buffer);
+  ResKey key;
+  memcpy (key.type, buffer, 4);
+  const unsigned char* s = buffer + 4;
+  key.id = get_word (s);
+  return key;
+  }
+
+static void
+apply_ops (FILE* patch, const Datablock& source, output& out) {
+  for (;;) {
+    int op = getc (patch);
+    if (op == OP_END)
+      return;
+    else if (op == OP_COPY) {
+      unsigned long offset = read_varint (patch);
+      unsigned long len = read_varint (patch);
+      if (offset > (unsigned long) source.size()
+	  || len > source.size() - offset)
+	throw "patch copies from outside its source";
+      out.write (source.contents() + offset, len);
+      }
+    else if (op == OP_INSERT) {
+      unsigned long len = read_varint (patch);
+      unsigned char buffer[8192];
+      while (len > 0) {
+	size_t n = (len < sizeof buffer)? len : sizeof buffer;
+	read_bytes (patch, buffer, n);
+	out.write (buffer, n);
+	len -= n;
+	}
+      }
+    else if (op == EOF)
+      throw "patch is truncated";
+    else
+      throw "patch is corrupt";
+    }
+  }
+
+static void
+apply_patch (FILE* patch, const Datablock& old_file, output& out) {
+  unsigned char buffer[5];
+  read_bytes (patch, buffer, sizeof buffer);
+  if (memcmp (buffer, patch_magic, 4) != 0)
+    throw "not a prc-delta patch";
+  if (buffer[4] != patch_version)
+    throw "unsupported patch version";
+
+  unsigned char crc[4];
+  const unsigned char* s;
+  unsigned long old_size = read_varint (patch);
+  read_bytes (patch, crc, 4);
+  s = crc;
+  unsigned long old_crc = get_long (s);
+  if (old_size != (unsigned long) old_file.size()
+      || old_crc != crc32_update (0, old_file.contents(), old_file.size()))
+    throw "patch does not apply to this version of the database";
+
+  unsigned long new_size = read_varint (patch);
+  read_bytes (patch, crc, 4);
+  s = crc;
+  unsigned long new_crc = get_long (s);
+
+  resource_layout old_layout = layout_of_resource_file (old_file);
+  ResourceDatabase old_db (old_file);
+
+  for (;;) {
+    int seg = getc (patch);
+    if (seg == SEG_END)
+      break;
+    else if (seg == SEG_PREFIX)
+      apply_ops (patch, old_file (0, old_layout.prefix_size), out);
+    else if (seg == SEG_SAME || seg == SEG_RESOURCE) {
+      ResourceDatabase::const_iterator it = old_db.find (read_key (patch));
+      if (it == old_db.end())
+	throw "patch refers to a resource missing from the old database";
+      if (seg == SEG_SAME)
+	out.write ((*it).second.contents(), (*it).second.size());
+      else
+	apply_ops (patch, (*it).second, out);
+      }
+    else if (seg == SEG_NEW)
+      apply_ops (patch, Datablock (), out);
+    else if (seg == EOF)
+      throw "patch is truncated";
+    else
+      throw "patch is corrupt";
+    }
+
+  if (out.size != new_size || out.crc != new_crc)
+    throw "patched database does not match the original (CRC mismatch)";
+  }
+
+
+int
+main (int argc, char** argv) {
+  bool work_desired = true;
+  const char* output_fname = NULL;
+  int c;
+
+  set_progname (argv[0]);
+
+  while ((c = getopt_long (argc, argv, shortopts, longopts, NULL)) >= 0)
+    switch (c) {
+    case 'o':
+      output_fname = optarg;
+      break;
+
+    case OPTION_HELP:
+      usage();
+      work_desired = false;
+      break;
+
+    case OPTION_VERSION:
+      print_version ("prc-patch", "J");
+      work_desired = false;
+      break;
+      }
+
+  if (!work_desired)
+    return EXIT_SUCCESS;
+
+  if (argc - optind < 1 || argc - optind > 2) {
+    usage();
+    return EXIT_FAILURE;
+    }
+
+  const char* old_fname = argv[optind];
+  const char* patch_fname = (argc - optind == 2)? argv[optind + 1] : "-";
+
+  FILE* patch = (strcmp (patch_fname, "-") == 0)? stdin
+	      : fopen (patch_fname, "rb");
+  if (patch == NULL) {
+    error ("can't open '%s': @P", patch_fname);
+    return EXIT_FAILURE;
+    }
+
+  Datablock old_file;
+  try {
+    old_file = slurp_file_as_datablock (old_fname);
+    } catch (const char* message) {
+    error ("[%s] %s", old_fname, message);
+    return EXIT_FAILURE;
+    }
+
+  FILE* f = stdout;
+  if (output_fname && (f = fopen (output_fname, "wb")) == NULL) {
+    error ("can't write to '%s': @P", output_fname);
+    return EXIT_FAILURE;
+    }
+
+  output out (f);
+  try {
+    apply_patch (patch, old_file, out);
+    } catch (const char* message) {
+    error ("[%s] %s", patch_fname, message);
+    }
+
+  if (ferror (f) || (f != stdout && fclose (f) != 0))
+    error ("error writing to '%s': @P",
+	   output_fname? output_fname : "standard output");
+  if (patch != stdin)
+    fclose (patch);
+
+  if (nerrors) {
+    if (output_fname)
+      remove (output_fname);
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+  }
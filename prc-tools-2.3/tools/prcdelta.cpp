@@ -0,0 +1,93 @@
+/* prcdelta.cpp: routines shared by prc-delta and prc-patch.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#include <string.h>
+
+#include "prcdelta.hpp"
+#include "pfdio.hpp"
+
+// The usual reflected CRC-32, as used by zlib and PKZIP.
+
+unsigned long
+crc32_update (unsigned long crc, const unsigned char* s, unsigned long len) {
+  static unsigned long table[256];
+  static bool initialized = false;
+
+  if (!initialized) {
+    for (unsigned int i = 0; i < 256; i++) {
+      unsigned long c = i;
+      for (int k = 0; k < 8; k++)
+	c = (c & 1)? 0xedb88320ul ^ (c >> 1) : c >> 1;
+      table[i] = c;
+      }
+    initialized = true;
+    }
+
+  crc = ~crc & 0xfffffffful;
+  while (len-- > 0)
+    crc = table[(crc ^ *s++) & 0xff] ^ (crc >> 8);
+  return ~crc & 0xfffffffful;
+  }
+
+void
+put_varint (std::vector<unsigned char>& out, unsigned long v) {
+  while (v >= 0x80) {
+    out.push_back ((v & 0x7f) | 0x80);
+    v >>= 7;
+    }
+  out.push_back (v);
+  }
+
+bool
+get_varint (FILE* f, unsigned long& v) {
+  v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    int c = getc (f);
+    if (c == EOF)
+      return false;
+    v |= (unsigned long) (c & 0x7f) << shift;
+    if ((c & 0x80) == 0)
+      return true;
+    }
+
+  return false;
+  }
+
+resource_layout
+layout_of_resource_file (const Datablock& file) {
+  const long header_size = 76;
+  resource_layout layout;
+
+  if (file.size() < header_size + 2)
+    throw "not a resource database";
+
+  const unsigned char* s = file.contents() + 32;
+  if ((get_word (s) & 0x0001) == 0)
+    throw "not a resource database";
+
+  s = file.contents() + header_size;
+  unsigned int n = get_word (s);
+  if (file.size() < header_size + 2 + 10 * long (n))
+    throw "resource directory is truncated";
+
+  layout.prefix_size = file.size();
+  unsigned long prev = header_size + 2 + 10 * n;
+  for (unsigned int i = 0; i < n; i++) {
+    ResKey key;
+    memcpy (key.type, s, 4), s += 4;
+    key.id = get_word (s);
+    unsigned long offset = get_long (s);
+    if (offset < prev || offset > (unsigned long) file.size())
+      throw "resource data is out of order";
+    if (i == 0)
+      layout.prefix_size = offset;
+    layout.keys.push_back (key);
+    prev = offset;
+    }
+
+  return layout;
+  }
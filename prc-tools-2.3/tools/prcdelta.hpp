@@ -0,0 +1,66 @@
+/* prcdelta.hpp: the patch format shared by prc-delta and prc-patch.
+
+   This is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.  */
+
+#ifndef PRCDELTA_HPP
+#define PRCDELTA_HPP
+
+#include <vector>
+
+#include <stdio.h>
+
+#include "pfd.hpp"
+
+/* A patch describes the new file as a sequence of segments, in the order
+   in which they appear in it:  first everything before the resource data
+   (the header, directory, and any AppInfo and SortInfo blocks), then each
+   resource's data in directory order.  So prc-patch can write the new file
+   as it reads the patch, and needs random access only to the old file.
+
+     patch   := "PRCd" VERSION old-size old-crc new-size new-crc segment* 'E'
+     segment := 'S' type id			the old resource, unchanged
+	      | 'P' op* 'e'			edits of the old prefix
+	      | 'R' type id op* 'e'		edits of that old resource
+	      | 'N' op* 'e'			new contents (inserts only)
+     op      := 'c' offset length		copy from the segment's source
+	      | 'i' length byte*		insert literal bytes
+
+   Sizes, offsets, and lengths are unsigned varints (seven bits per byte,
+   least significant first, with the top bit set on all but the last);
+   CRCs are 32-bit big-endian CRC-32s of the whole files; VERSION is one
+   byte; and type and id are four bytes and a big-endian word.  */
+
+static const char patch_magic[4] = { 'P', 'R', 'C', 'd' };
+static const unsigned int patch_version = 1;
+
+enum {
+  SEG_SAME = 'S',
+  SEG_PREFIX = 'P',
+  SEG_RESOURCE = 'R',
+  SEG_NEW = 'N',
+  SEG_END = 'E',
+  OP_COPY = 'c',
+  OP_INSERT = 'i',
+  OP_END = 'e'
+  };
+
+unsigned long crc32_update (unsigned long crc, const unsigned char* s,
+			    unsigned long len);
+
+void put_varint (std::vector<unsigned char>& out, unsigned long v);
+bool get_varint (FILE* f, unsigned long& v);
+
+/* The resources of a resource database file, in directory order, with the
+   length of the prefix before their data.  */
+
+struct resource_layout {
+  std::vector<ResKey> keys;
+  long prefix_size;
+  };
+
+resource_layout layout_of_resource_file (const Datablock& file);
+
+#endif